@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/sources/network/common/poller.cpp" "CMakeFiles/tacopie.dir/sources/network/common/poller.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/common/poller.cpp.o.d"
+  "/root/repo/sources/network/common/select_poller.cpp" "CMakeFiles/tacopie.dir/sources/network/common/select_poller.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/common/select_poller.cpp.o.d"
+  "/root/repo/sources/network/common/tcp_socket.cpp" "CMakeFiles/tacopie.dir/sources/network/common/tcp_socket.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/common/tcp_socket.cpp.o.d"
+  "/root/repo/sources/network/io_service.cpp" "CMakeFiles/tacopie.dir/sources/network/io_service.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/io_service.cpp.o.d"
+  "/root/repo/sources/network/io_service_group.cpp" "CMakeFiles/tacopie.dir/sources/network/io_service_group.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/io_service_group.cpp.o.d"
+  "/root/repo/sources/network/tcp_client.cpp" "CMakeFiles/tacopie.dir/sources/network/tcp_client.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/tcp_client.cpp.o.d"
+  "/root/repo/sources/network/tcp_server.cpp" "CMakeFiles/tacopie.dir/sources/network/tcp_server.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/tcp_server.cpp.o.d"
+  "/root/repo/sources/network/unix/epoll_poller.cpp" "CMakeFiles/tacopie.dir/sources/network/unix/epoll_poller.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/unix/epoll_poller.cpp.o.d"
+  "/root/repo/sources/network/unix/io_uring_poller.cpp" "CMakeFiles/tacopie.dir/sources/network/unix/io_uring_poller.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/unix/io_uring_poller.cpp.o.d"
+  "/root/repo/sources/network/unix/poll_poller.cpp" "CMakeFiles/tacopie.dir/sources/network/unix/poll_poller.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/unix/poll_poller.cpp.o.d"
+  "/root/repo/sources/network/unix/unix_self_pipe.cpp" "CMakeFiles/tacopie.dir/sources/network/unix/unix_self_pipe.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/unix/unix_self_pipe.cpp.o.d"
+  "/root/repo/sources/network/unix/unix_tcp_socket.cpp" "CMakeFiles/tacopie.dir/sources/network/unix/unix_tcp_socket.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/network/unix/unix_tcp_socket.cpp.o.d"
+  "/root/repo/sources/utils/error.cpp" "CMakeFiles/tacopie.dir/sources/utils/error.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/error.cpp.o.d"
+  "/root/repo/sources/utils/flight_recorder.cpp" "CMakeFiles/tacopie.dir/sources/utils/flight_recorder.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/flight_recorder.cpp.o.d"
+  "/root/repo/sources/utils/histogram.cpp" "CMakeFiles/tacopie.dir/sources/utils/histogram.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/histogram.cpp.o.d"
+  "/root/repo/sources/utils/logger.cpp" "CMakeFiles/tacopie.dir/sources/utils/logger.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/logger.cpp.o.d"
+  "/root/repo/sources/utils/strand.cpp" "CMakeFiles/tacopie.dir/sources/utils/strand.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/strand.cpp.o.d"
+  "/root/repo/sources/utils/thread_config.cpp" "CMakeFiles/tacopie.dir/sources/utils/thread_config.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/thread_config.cpp.o.d"
+  "/root/repo/sources/utils/thread_pool.cpp" "CMakeFiles/tacopie.dir/sources/utils/thread_pool.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/thread_pool.cpp.o.d"
+  "/root/repo/sources/utils/timer_wheel.cpp" "CMakeFiles/tacopie.dir/sources/utils/timer_wheel.cpp.o" "gcc" "CMakeFiles/tacopie.dir/sources/utils/timer_wheel.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
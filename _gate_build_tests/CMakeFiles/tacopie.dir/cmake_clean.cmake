@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tacopie.dir/sources/network/common/poller.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/common/poller.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/common/select_poller.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/common/select_poller.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/common/tcp_socket.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/common/tcp_socket.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/io_service.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/io_service.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/io_service_group.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/io_service_group.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/tcp_client.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/tcp_client.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/tcp_server.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/tcp_server.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/unix/epoll_poller.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/unix/epoll_poller.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/unix/io_uring_poller.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/unix/io_uring_poller.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/unix/poll_poller.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/unix/poll_poller.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/unix/unix_self_pipe.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/unix/unix_self_pipe.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/network/unix/unix_tcp_socket.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/network/unix/unix_tcp_socket.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/error.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/error.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/flight_recorder.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/flight_recorder.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/histogram.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/histogram.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/logger.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/logger.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/strand.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/strand.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/thread_config.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/thread_config.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/thread_pool.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/thread_pool.cpp.o.d"
+  "CMakeFiles/tacopie.dir/sources/utils/timer_wheel.cpp.o"
+  "CMakeFiles/tacopie.dir/sources/utils/timer_wheel.cpp.o.d"
+  "lib/libtacopie.a"
+  "lib/libtacopie.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tacopie.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/sources/main.cpp" "tests/CMakeFiles/tacopie_tests.dir/sources/main.cpp.o" "gcc" "tests/CMakeFiles/tacopie_tests.dir/sources/main.cpp.o.d"
+  "/root/repo/tests/sources/spec/small_function_spec.cpp" "tests/CMakeFiles/tacopie_tests.dir/sources/spec/small_function_spec.cpp.o" "gcc" "tests/CMakeFiles/tacopie_tests.dir/sources/spec/small_function_spec.cpp.o.d"
+  "/root/repo/tests/sources/spec/timer_wheel_spec.cpp" "tests/CMakeFiles/tacopie_tests.dir/sources/spec/timer_wheel_spec.cpp.o" "gcc" "tests/CMakeFiles/tacopie_tests.dir/sources/spec/timer_wheel_spec.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build_tests/CMakeFiles/tacopie.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "../bin/tacopie_tests"
+  "../bin/tacopie_tests.pdb"
+  "CMakeFiles/tacopie_tests.dir/sources/main.cpp.o"
+  "CMakeFiles/tacopie_tests.dir/sources/main.cpp.o.d"
+  "CMakeFiles/tacopie_tests.dir/sources/spec/small_function_spec.cpp.o"
+  "CMakeFiles/tacopie_tests.dir/sources/spec/small_function_spec.cpp.o.d"
+  "CMakeFiles/tacopie_tests.dir/sources/spec/timer_wheel_spec.cpp.o"
+  "CMakeFiles/tacopie_tests.dir/sources/spec/timer_wheel_spec.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tacopie_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,103 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+
+#include <tacopie/network/poller.hpp>
+
+namespace tacopie {
+
+//!
+//! epoll() based poller, linux only
+//! fds are registered once in the kernel and each wait only costs as much as the number of ready fds
+//!
+class epoll_poller : public poller_iface {
+public:
+  //! ctor
+  epoll_poller(void);
+  //! dtor
+  ~epoll_poller(void);
+
+  //! copy ctor
+  epoll_poller(const epoll_poller&) = delete;
+  //! assignment operator
+  epoll_poller& operator=(const epoll_poller&) = delete;
+
+public:
+  //!
+  //! register a fd
+  //!
+  //! \param fd fd to be polled
+  //! \param events combination of event_type to poll for
+  //! \param persistent if true, the fd is never disarmed when an event is reported
+  //!
+  void add(fd_t fd, int events, bool persistent);
+
+  //!
+  //! update (and re-arm) the interest of a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  void modify(fd_t fd, int events);
+
+  //!
+  //! unregister a fd
+  //!
+  //! \param fd registered fd
+  //!
+  void remove(fd_t fd);
+
+  //!
+  //! wait for events
+  //!
+  //! \param events vector filled with the reported events (cleared first)
+  //! \param timeout_msecs maximum time to wait, -1 to block until an event is reported
+  //!
+  void wait(std::vector<event>& events, int timeout_msecs);
+
+public:
+  //!
+  //! \return the type of the poller
+  //!
+  poller_type get_type(void) const;
+
+private:
+  //!
+  //! epoll instance
+  //!
+  fd_t m_epoll_fd;
+
+  //!
+  //! buffer given to epoll_wait, grows whenever it gets filled
+  //!
+  std::vector<struct epoll_event> m_epoll_events;
+};
+
+} // namespace tacopie
+
+#endif /* __linux__ */
@@ -23,41 +23,88 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
-#ifdef _WIN32
-#include <winsock2.h>
-#else
-#include <sys/select.h>
-#endif /* _WIN32 */
-
+#include <tacopie/network/poller.hpp>
 #include <tacopie/network/self_pipe.hpp>
 #include <tacopie/network/tcp_socket.hpp>
+#include <tacopie/utils/fd_table.hpp>
+#include <tacopie/utils/histogram.hpp>
+#include <tacopie/utils/mpsc_queue.hpp>
+#include <tacopie/utils/ring_queue.hpp>
+#include <tacopie/utils/small_function.hpp>
+#include <tacopie/utils/strand.hpp>
 #include <tacopie/utils/thread_pool.hpp>
+#include <tacopie/utils/timer_wheel.hpp>
 
 #ifndef __TACOPIE_IO_SERVICE_NB_WORKERS
 #define __TACOPIE_IO_SERVICE_NB_WORKERS 1
 #endif /* __TACOPIE_IO_SERVICE_NB_WORKERS */
 
+#ifndef __TACOPIE_IO_SERVICE_MAX_POSTED_TASKS_BATCH
+#define __TACOPIE_IO_SERVICE_MAX_POSTED_TASKS_BATCH 1024
+#endif /* __TACOPIE_IO_SERVICE_MAX_POSTED_TASKS_BATCH */
+
+#ifndef __TACOPIE_IO_SERVICE_MAX_EVENTS_PER_ITERATION
+#define __TACOPIE_IO_SERVICE_MAX_EVENTS_PER_ITERATION 1024
+#endif /* __TACOPIE_IO_SERVICE_MAX_EVENTS_PER_ITERATION */
+
+#ifndef __TACOPIE_IO_SERVICE_EVENTS_CHUNK_SIZE
+#define __TACOPIE_IO_SERVICE_EVENTS_CHUNK_SIZE 64
+#endif /* __TACOPIE_IO_SERVICE_EVENTS_CHUNK_SIZE */
+
 namespace tacopie {
 
 //!
 //! service that operates IO Handling.
 //! It polls sockets for input and output, processes read and write operations and calls the appropriate callbacks.
+//! Polling relies on a poller (select, poll, epoll or io_uring) chosen at construction.
+//! By default, __TACOPIE_DEFAULT_POLLER is used (epoll on linux and select on other platforms).
+//! The poll loop is either run by a background thread, or driven by the application (see loop_mode).
 //!
 class io_service {
 public:
   //!
-  //! ctor
+  //! how the poll loop is driven
+  //!
+  enum class loop_mode {
+    //! by a poll thread started at construction, callbacks being executed by the callback workers (default)
+    background_thread,
+    //! by the application, through run, run_once or poll_once: no thread is created and callbacks are executed by the calling thread
+    caller_thread
+  };
+
+public:
+  //!
+  //! ctor, uses the default poller (__TACOPIE_DEFAULT_POLLER)
   //!
   io_service(void);
 
+  //!
+  //! ctor
+  //!
+  //! \param type poller to be used, falls back to the closest available one if not supported on this platform
+  //!
+  explicit io_service(poller_type type);
+
+  //!
+  //! ctor
+  //! in loop_mode::caller_thread, the io_service has no callback worker and uses callback_mode::poll_thread, so that callbacks are executed by the thread running the loop
+  //! workers can still be added with set_nb_workers for the sockets switched to callback_mode::workers: until then, their callbacks (and the timers) are executed by the thread running the loop as well
+  //!
+  //! \param type poller to be used, falls back to the closest available one if not supported on this platform
+  //! \param mode how the poll loop is driven
+  //!
+  io_service(poller_type type, loop_mode mode);
+
   //! dtor
   ~io_service(void);
 
@@ -76,21 +123,280 @@ public:
   //!
   void set_nb_workers(std::size_t nb_threads);
 
+  //!
+  //! \return type of the poller actually in use (may differ from the requested one in case of fallback)
+  //!
+  poller_type get_poller_type(void) const;
+
+  //!
+  //! restrict the poll thread to run on the given cpus
+  //! not available in loop_mode::caller_thread (there is no poll thread)
+  //!
+  //! \param cpus indexes of the cpus the poll thread is allowed to run on
+  //!
+  void set_poll_thread_affinity(const std::vector<std::size_t>& cpus);
+
+  //!
+  //! name the poll thread, as displayed by top, perf or debuggers (tacopie-poll by default)
+  //! not available in loop_mode::caller_thread (there is no poll thread)
+  //!
+  //! \param name name of the poll thread
+  //!
+  void set_poll_thread_name(const std::string& name);
+
+  //!
+  //! restrict the callback workers to run on the given cpus
+  //! worker i is restricted to cpus[i % cpus.size()] (see utils::thread_pool::set_workers_affinity)
+  //!
+  //! \param cpus sets of cpus the workers are allowed to run on
+  //!
+  void set_workers_affinity(const std::vector<std::vector<std::size_t>>& cpus);
+
+  //!
+  //! name the callback workers <name>-<i> (tacopie-wrk by default)
+  //!
+  //! \param name prefix of the workers name
+  //!
+  void set_workers_name(const std::string& name);
+
+  //!
+  //! \return number of sockets currently tracked by the io_service
+  //!
+  std::size_t get_nb_tracked_sockets(void) const;
+
+  //!
+  //! \return number of times the poll thread has been woken up through the notifier
+  //!
+  std::uint64_t get_nb_wakeups(void) const;
+
+  //!
+  //! \return number of wake up requests that did not require any syscall, as a wake up was already pending
+  //!
+  std::uint64_t get_nb_suppressed_wakeups(void) const;
+
+public:
+  //!
+  //! run the poll loop on the calling thread until stop is called (loop_mode::caller_thread only)
+  //! the loop must be run by a single thread at a time, and must not be run from one of its callbacks
+  //!
+  void run(void);
+
+  //!
+  //! run a single iteration of the poll loop on the calling thread (loop_mode::caller_thread only)
+  //! waits for events until the timeout expires (or the next timer expires), then processes events, timers and posted tasks
+  //!
+  //! \param timeout_msecs maximum time to wait for events (-1 to wait until an event is reported)
+  //!
+  void run_once(int timeout_msecs = -1);
+
+  //!
+  //! run a single iteration of the poll loop on the calling thread, without waiting for events (loop_mode::caller_thread only)
+  //!
+  void poll_once(void);
+
+  //!
+  //! make run return once its current iteration completes
+  //! if run is not running, the next call to run returns right away
+  //!
+  void stop(void);
+
+public:
+  //!
+  //! configure busy polling: before blocking on the poller, the poll thread spins on non-blocking readiness checks
+  //! this trades cpu for latency: the spin stops as soon as an event is reported or once any of the spin budgets is exhausted
+  //! busy polling is disabled when both spin_usecs and max_spins are 0 (default)
+  //! this can be safely called at runtime, even if the io_service is currently running
+  //!
+  //! \param spin_usecs maximum time spent spinning before blocking, in microseconds (0 for no time limit)
+  //! \param max_spins maximum number of readiness checks before blocking (0 for no limit)
+  //! \param socket_busy_poll_usecs SO_BUSY_POLL value set on the sockets tracked from now on (linux only, 0 to leave the sockets untouched)
+  //!
+  void set_busy_poll(std::uint32_t spin_usecs, std::uint32_t max_spins = 0, std::uint32_t socket_busy_poll_usecs = 0);
+
+  //!
+  //! \return number of spins that found events, avoiding a blocking wait
+  //!
+  std::uint64_t get_nb_busy_poll_hits(void) const;
+
+  //!
+  //! \return number of spins that exhausted their budget without finding any event, followed by a blocking wait
+  //!
+  std::uint64_t get_nb_busy_poll_misses(void) const;
+
+public:
+  //!
+  //! snapshot of the io_service statistics
+  //! counters are cumulated since the construction of the io_service, gauges reflect the state at the time of the snapshot
+  //! fields are read independently from each other, without locking: a snapshot taken while the loop is running is not perfectly consistent
+  //!
+  struct stats {
+    //! number of iterations of the poll loop
+    std::uint64_t nb_iterations;
+    //! number of socket events reported by the poller (notifier events excluded)
+    std::uint64_t nb_events;
+    //! highest number of socket events reported by a single wait
+    std::uint64_t max_events_per_wakeup;
+    //! time spent waiting on the poller (busy polling included), in nanoseconds
+    std::uint64_t wait_time_nsecs;
+    //! time spent processing pending updates, events, timers and posted tasks, in nanoseconds
+    std::uint64_t processing_time_nsecs;
+    //! number of times the poll thread has been woken up through the notifier
+    std::uint64_t nb_wakeups;
+    //! number of wake up requests suppressed as a wake up was already pending
+    std::uint64_t nb_suppressed_wakeups;
+    //! number of spins that found events
+    std::uint64_t nb_busy_poll_hits;
+    //! number of spins that exhausted their budget
+    std::uint64_t nb_busy_poll_misses;
+    //! number of tracked sockets (gauge)
+    std::size_t nb_tracked_sockets;
+    //! number of callbacks waiting for a callback worker (gauge)
+    std::size_t nb_pending_callbacks;
+    //! number of events carried over to the next iteration (gauge)
+    std::size_t nb_carried_over_events;
+  };
+
+  //!
+  //! \return snapshot of the statistics, can be called at any time from any thread (lock-free)
+  //!
+  stats get_stats(void) const;
+
+public:
+  //!
+  //! latency histograms of the read and write callbacks, values in nanoseconds
+  //!
+  struct latency_histograms {
+    //! time between the poller reporting the socket ready and the start of its callback (time spent in the poll loop, and waiting for a callback worker)
+    utils::histogram dispatch_latency;
+    //! execution time of the callbacks
+    utils::histogram callback_time;
+  };
+
+  //!
+  //! enable or disable the recording of the latency histograms of the io_service (disabled by default)
+  //! when disabled, no timestamp is taken and callbacks are not wrapped
+  //!
+  //! \param enabled whether latency should be recorded
+  //!
+  void set_latency_tracking(bool enabled);
+
+  //!
+  //! \return latency histograms of all the sockets tracked by the io_service (only updated while latency tracking is enabled)
+  //!
+  const latency_histograms& get_latency_histograms(void) const;
+
+  //!
+  //! enable or disable the recording of latency histograms dedicated to a tracked socket (independently from the io_service ones)
+  //! if socket is not tracked yet, track it
+  //!
+  //! \param socket tracked socket
+  //! \param enabled whether latency should be recorded for this socket (disabling drops the histograms of the socket)
+  //!
+  void set_latency_tracking(const tcp_socket& socket, bool enabled);
+
+  //!
+  //! \param socket tracked socket
+  //! \return latency histograms of the socket, null if latency tracking is not enabled for this socket (remain valid once the socket is untracked)
+  //!
+  std::shared_ptr<const latency_histograms> get_latency_histograms(const tcp_socket& socket);
+
+public:
+  //!
+  //! set the maximum number of socket events dispatched per iteration of the poll loop
+  //! events beyond the budget are carried over to the next iterations, ahead of the newly reported ones, so that every ready socket is served in turn
+  //! timers, posted tasks and queued updates are processed between two iterations
+  //! by default, __TACOPIE_IO_SERVICE_MAX_EVENTS_PER_ITERATION is used
+  //!
+  //! \param max_events maximum number of events per iteration (0 for no limit)
+  //!
+  void set_max_events_per_iteration(std::size_t max_events);
+
 public:
   //! callback handler typedef
   //! called on new socket event if register to io_service
-  typedef std::function<void(fd_t)> event_callback_t;
+  //! move-only, stored inline (without allocation) if it fits in __TACOPIE_SMALL_FUNCTION_SIZE bytes
+  typedef utils::small_function<void(fd_t)> event_callback_t;
+
+  //!
+  //! how the read and write callbacks of a socket are executed
+  //!
+  enum class callback_mode {
+    //! callbacks are pushed to the callback workers (default)
+    workers,
+    //! callbacks are executed directly by the poll thread, avoiding any cross-thread handoff
+    //! callbacks must then be short and must not block: no other event is processed while they run
+    poll_thread
+  };
+
+  //!
+  //! set the callback mode applied to the sockets tracked from now on
+  //!
+  //! \param mode callback mode
+  //!
+  void set_callback_mode(callback_mode mode);
+
+  //!
+  //! set the callback mode of a tracked socket (overrides the io_service callback mode for this socket)
+  //! if socket is not tracked yet, track it
+  //!
+  //! \param socket tracked socket
+  //! \param mode callback mode
+  //!
+  void set_callback_mode(const tcp_socket& socket, callback_mode mode);
+
+  //!
+  //! priority of a tracked socket
+  //! events of high priority sockets are dispatched ahead of the normal priority ones, and their callbacks are executed first by the callback workers
+  //!
+  typedef utils::thread_pool::priority priority;
+
+  //!
+  //! set the priority of a tracked socket (normal by default)
+  //! if socket is not tracked yet, track it
+  //!
+  //! \param socket tracked socket
+  //! \param socket_priority priority of the socket
+  //!
+  void set_priority(const tcp_socket& socket, priority socket_priority);
+
+  //!
+  //! set the maximum number of high priority events (and callbacks) processed in a row while normal priority ones are pending, so that normal priority sockets are not starved
+  //! applies both to the dispatch of the events by the poll loop and to the execution of the callbacks by the callback workers
+  //! by default, __TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE is used
+  //!
+  //! \param share number of high priority events processed for each normal priority one (0 for strict priority)
+  //!
+  void set_high_priority_share(std::size_t share);
+
+  //!
+  //! \return a new strand executing its tasks on the callback workers of this io_service (on the thread running the loop in loop_mode::caller_thread)
+  //! the strand must not be used once the io_service has been destroyed
+  //!
+  //! \param strand_priority priority of the tasks of the strand on the callback workers (it should match the priority of the sockets using the strand)
+  //!
+  std::shared_ptr<utils::strand> make_strand(priority strand_priority = priority::normal);
+
+  //!
+  //! execute the read and write callbacks of a tracked socket through a strand, so that they never run concurrently
+  //! the strand takes precedence over the callback mode: the callbacks are executed by the callback workers, one at a time
+  //! if socket is not tracked yet, track it
+  //!
+  //! \param socket tracked socket
+  //! \param strand strand executing the callbacks (nullptr to stop using a strand)
+  //!
+  void set_strand(const tcp_socket& socket, const std::shared_ptr<utils::strand>& strand);
 
   //!
   //! track socket
   //! add socket to io_service tracking for read/write operation
-  //! socket is polled only if read or write callback is defined
+  //! socket is polled only if read, write or error callback is defined
   //!
   //! \param socket socket to be tracked
   //! \param rd_callback callback to be executed on read event
   //! \param wr_callback callback to be executed on write event
+  //! \param err_callback callback to be executed on error or hangup (see set_err_callback)
   //!
-  void track(const tcp_socket& socket, const event_callback_t& rd_callback = nullptr, const event_callback_t& wr_callback = nullptr);
+  void track(const tcp_socket& socket, event_callback_t rd_callback = nullptr, event_callback_t wr_callback = nullptr, event_callback_t err_callback = nullptr);
 
   //!
   //! update the read callback
@@ -99,7 +405,7 @@ public:
   //! \param socket socket to be tracked
   //! \param event_callback callback to be executed on read event
   //!
-  void set_rd_callback(const tcp_socket& socket, const event_callback_t& event_callback);
+  void set_rd_callback(const tcp_socket& socket, event_callback_t event_callback);
 
   //!
   //! update the write callback
@@ -108,7 +414,19 @@ public:
   //! \param socket socket to be tracked
   //! \param event_callback callback to be executed on write event
   //!
-  void set_wr_callback(const tcp_socket& socket, const event_callback_t& event_callback);
+  void set_wr_callback(const tcp_socket& socket, event_callback_t event_callback);
+
+  //!
+  //! update the error callback
+  //! called when the poller reports an error or a hangup (including the peer shutting its side down, where supported, see poller_iface::hup_event) while neither the read nor the write callback is dispatched
+  //! data may still be buffered when the peer shut its side down: the callback should check before dropping the connection (see tcp_socket::is_remotely_closed)
+  //! this way, a dead connection with no pending operation is noticed right away, while pending operations keep reporting failures through their own callback
+  //! if socket is not tracked yet, track it
+  //!
+  //! \param socket socket to be tracked
+  //! \param event_callback callback to be executed on error or hangup
+  //!
+  void set_err_callback(const tcp_socket& socket, event_callback_t event_callback);
 
   //!
   //! remove socket from io_service tracking
@@ -130,35 +448,355 @@ public:
   //!
   void wait_for_removal(const tcp_socket& socket);
 
+  //!
+  //! get a future completed once the socket has been effectively removed (that is, once all its pending callbacks are executed)
+  //! the future is specific to the currently tracked socket: it is not affected by the fd being reused afterwards
+  //! only the waiters of a socket are woken up by its removal
+  //!
+  //! \param socket socket to wait for
+  //! \return future completed on removal, already completed if the socket is not tracked
+  //!
+  std::shared_future<void> get_removal_future(const tcp_socket& socket);
+
+public:
+  //!
+  //! completion-based operations
+  //! with the io_uring poller, recv, send and accept can be submitted to the kernel directly, instead of waiting for the socket to be readable (or writable) and then calling them
+  //! the read (or write) callback of the socket is then called once the operation completed, and takes its result with take_rd_completion (or take_wr_completion)
+  //! submissions from the poll thread are batched with its next wait: this saves the syscall that follows each readiness event
+  //! the other pollers (and kernels older than linux 5.7) do not support completion-based operations: callbacks then perform the operations on readiness
+  //! tcp_client and tcp_server use completion-based operations whenever their io_service supports them
+  //!
+
+  //!
+  //! result of a completion-based operation
+  //!
+  typedef poller_iface::completion completion;
+
+  //!
+  //! \return whether completion-based operations are supported (the other functions below throw otherwise)
+  //!
+  bool supports_completions(void) const;
+
+  //!
+  //! submit a recv of up to size bytes, the read callback is called once it completed
+  //! does nothing if a recv is already in progress, or if received bytes have not been taken yet (the read callback is called for them)
+  //!
+  //! \param socket tracked socket
+  //! \param size maximum number of bytes to receive
+  //!
+  void submit_recv(const tcp_socket& socket, std::size_t size);
+
+  //!
+  //! submit a send, the write callback is called once it completed
+  //! a single send can be in progress: the next one must be submitted once the result of the previous one has been taken
+  //!
+  //! \param socket tracked socket
+  //! \param buffer bytes to be sent
+  //! \param token value returned along with the result of the send, to identify it
+  //!
+  void submit_send(const tcp_socket& socket, std::vector<char> buffer, std::uint64_t token = 0);
+
+  //!
+  //! submit an accept, the read callback is called once a connection has been accepted
+  //! the accepted connection is taken with take_rd_completion, and turned into a tcp_socket with tcp_socket::accept
+  //!
+  //! \param socket tracked listening socket
+  //!
+  void submit_accept(const tcp_socket& socket);
+
+  //!
+  //! take the result of a completed recv or accept
+  //! received bytes beyond max_size are kept: the read callback is called again for them once the current one completes
+  //!
+  //! \param socket tracked socket
+  //! \param max_size maximum number of received bytes to take
+  //! \param result filled with the result of the operation
+  //! \return false if the operation has not completed
+  //!
+  bool take_rd_completion(const tcp_socket& socket, std::size_t max_size, completion& result);
+
+  //!
+  //! take the result of a completed send
+  //!
+  //! \param socket tracked socket
+  //! \param result filled with the result of the operation
+  //! \return false if the operation has not completed
+  //!
+  bool take_wr_completion(const tcp_socket& socket, completion& result);
+
+public:
+  //!
+  //! tracking of raw fds
+  //! same as the tcp_socket functions above, for any descriptor the poller can wait on (timerfd, eventfd, signalfd, pipes, inotify, sockets not owned by a tcp_socket...)
+  //! regular files cannot be tracked (epoll rejects them), and only sockets can be tracked on windows
+  //! readiness is re-armed once the callback completes: callbacks must consume it (for instance, read the timerfd expirations), otherwise they are called again right away
+  //!
+
+  //!
+  //! track fd, see track
+  //!
+  //! \param fd fd to be tracked
+  //! \param rd_callback callback to be executed on read event
+  //! \param wr_callback callback to be executed on write event
+  //! \param err_callback callback to be executed on error or hangup
+  //!
+  void track_fd(fd_t fd, event_callback_t rd_callback = nullptr, event_callback_t wr_callback = nullptr, event_callback_t err_callback = nullptr);
+
+  //!
+  //! update the read callback of a fd, see set_rd_callback
+  //!
+  //! \param fd fd to be tracked
+  //! \param event_callback callback to be executed on read event
+  //!
+  void set_fd_rd_callback(fd_t fd, event_callback_t event_callback);
+
+  //!
+  //! update the write callback of a fd, see set_wr_callback
+  //!
+  //! \param fd fd to be tracked
+  //! \param event_callback callback to be executed on write event
+  //!
+  void set_fd_wr_callback(fd_t fd, event_callback_t event_callback);
+
+  //!
+  //! update the error callback of a fd, see set_err_callback
+  //!
+  //! \param fd fd to be tracked
+  //! \param event_callback callback to be executed on error or hangup
+  //!
+  void set_fd_err_callback(fd_t fd, event_callback_t event_callback);
+
+  //!
+  //! set the callback mode of a tracked fd, see set_callback_mode
+  //! callback_mode::poll_thread avoids handing the callbacks over to another thread, which suits short callbacks such as timerfd or eventfd ones
+  //!
+  //! \param fd tracked fd
+  //! \param mode callback mode
+  //!
+  void set_fd_callback_mode(fd_t fd, callback_mode mode);
+
+  //!
+  //! set the priority of a tracked fd, see set_priority
+  //!
+  //! \param fd tracked fd
+  //! \param fd_priority priority of the fd
+  //!
+  void set_fd_priority(fd_t fd, priority fd_priority);
+
+  //!
+  //! execute the callbacks of a tracked fd through a strand, see set_strand
+  //!
+  //! \param fd tracked fd
+  //! \param strand strand executing the callbacks (nullptr to stop using a strand)
+  //!
+  void set_fd_strand(fd_t fd, const std::shared_ptr<utils::strand>& strand);
+
+  //!
+  //! remove fd from io_service tracking, see untrack
+  //! the fd must not be closed before being untracked
+  //!
+  //! \param fd fd to be untracked
+  //!
+  void untrack_fd(fd_t fd);
+
+  //!
+  //! wait until the fd has been effectively removed, see wait_for_removal
+  //!
+  //! \param fd fd to wait for
+  //!
+  void wait_for_fd_removal(fd_t fd);
+
+  //!
+  //! get a future completed once the fd has been effectively removed, see get_removal_future
+  //!
+  //! \param fd fd to wait for
+  //! \return future completed on removal, already completed if the fd is not tracked
+  //!
+  std::shared_future<void> get_fd_removal_future(fd_t fd);
+
+public:
+  //! timer identifier
+  typedef utils::timer_wheel::timer_id_t timer_id_t;
+
+  //! callback executed on timer expiry
+  typedef std::function<void(void)> timer_callback_t;
+
+  //!
+  //! schedule a timer, driven by the poll loop
+  //! the callback is executed according to the io_service callback mode (by the callback workers, or directly by the poll thread)
+  //!
+  //! \param timeout_msecs delay after which the callback is executed
+  //! \param callback callback to be executed
+  //! \return id of the timer, to be used for cancellation
+  //!
+  timer_id_t schedule_after(std::uint32_t timeout_msecs, const timer_callback_t& callback);
+
+  //!
+  //! cancel a timer
+  //!
+  //! \param id id of the timer
+  //! \return true if the timer has been cancelled, false if it already expired (its callback may be running)
+  //!
+  bool cancel(timer_id_t id);
+
+public:
+  //! task to be executed by the poll thread
+  typedef utils::thread_pool::task_t task_t;
+
+  //!
+  //! queue a task to be executed by the poll thread, after the events of its current iteration have been processed
+  //! never executes the task before returning, even if called from the poll thread
+  //! tasks are executed in batches, in the order they have been posted (by a given thread)
+  //!
+  //! \param task task to be executed
+  //!
+  void post(task_t task);
+
+  //!
+  //! execute the task right away if called from the poll thread (or the thread running the loop in loop_mode::caller_thread), post it otherwise
+  //!
+  //! \param task task to be executed
+  //!
+  void dispatch(task_t task);
+
 private:
   //!
   //! struct tracked_socket
   //! contains information about what a current socket is tracking
-  //!  * rd_callback: callback to be executed on read availability
+  //!  * rd_callback: callback to be executed on read availability (lent to the executing context while being executed, see dispatched_callback)
   //!  * is_executing_rd_callback: whether the rd callback is currently being executed or not
-  //!  * wr_callback: callback to be executed on write availability
+  //!  * is_rd_callback_lent: whether the rd callback being executed must be given back once completed (that is, it has not been replaced in the meantime)
+  //!  * wr_callback: callback to be executed on write availability (lent to the executing context while being executed, see dispatched_callback)
   //!  * is_executing_wr_callback: whether the wr callback is currently being executed or not
+  //!  * is_wr_callback_lent: whether the wr callback being executed must be given back once completed
+  //!  * err_callback: callback to be executed on error or hangup (lent to the executing context while being executed, see dispatched_callback)
+  //!  * is_executing_err_callback: whether the err callback is currently being executed or not
+  //!  * is_err_callback_lent: whether the err callback being executed must be given back once completed
   //!  * marked_for_untrack: whether the socket is marked for being untrack (that is, will be untracked whenever all the callback completed their execution)
+  //!  * is_registered: whether the socket is currently registered in the poller
+  //!  * polled_events: events the socket is currently armed for in the poller
+  //!  * has_pending_update: whether the socket is queued in m_pending_updates
+  //!  * mode: how the callbacks of the socket are executed
+  //!  * strand: strand executing the callbacks of the socket (may be null)
+  //!  * latency: latency histograms of the socket (null unless enabled)
+  //!  * socket_priority: priority of the socket
+  //!  * removal: promise fulfilled on removal (null unless get_removal_future has been called)
+  //!  * removal_future: future of the removal promise, shared by all the waiters
   //!
   //!
   struct tracked_socket {
     //! ctor
     tracked_socket(void)
     : rd_callback(nullptr)
-    , wr_callback(nullptr) {}
+    , wr_callback(nullptr)
+    , err_callback(nullptr) {}
+
+    //! \return whether any of the callbacks is being executed
+    bool
+    is_executing_callback(void) const {
+      return is_executing_rd_callback || is_executing_wr_callback || is_executing_err_callback;
+    }
 
     //! rd event
     event_callback_t rd_callback;
     std::atomic<bool> is_executing_rd_callback = ATOMIC_VAR_INIT(false);
+    bool is_rd_callback_lent                   = false;
 
     //! wr event
     event_callback_t wr_callback;
     std::atomic<bool> is_executing_wr_callback = ATOMIC_VAR_INIT(false);
+    bool is_wr_callback_lent                   = false;
+
+    //! err event
+    event_callback_t err_callback;
+    std::atomic<bool> is_executing_err_callback = ATOMIC_VAR_INIT(false);
+    bool is_err_callback_lent                   = false;
 
     //! marked for untrack
     std::atomic<bool> marked_for_untrack = ATOMIC_VAR_INIT(false);
+
+    //! poller registration
+    bool is_registered = false;
+    int polled_events       = poller_iface::no_event;
+    bool has_pending_update = false;
+
+    //! callback execution
+    callback_mode mode = callback_mode::workers;
+    std::shared_ptr<utils::strand> strand;
+
+    //! latency tracking
+    std::shared_ptr<latency_histograms> latency;
+
+    //! priority
+    priority socket_priority = priority::normal;
+
+    //! removal completion
+    std::unique_ptr<std::promise<void>> removal;
+    std::shared_future<void> removal_future;
+  };
+
+  //!
+  //! struct ready_event
+  //! event reported by the poller, waiting to be dispatched by process_events
+  //! the generation of the tracked socket is recorded so that the event is dropped if the fd is reused in the meantime
+  //!
+  struct ready_event {
+    fd_t fd;
+    int events;
+    std::uint64_t generation;
+    std::chrono::steady_clock::time_point reported_at;
+  };
+
+  //!
+  //! struct dispatched_callback
+  //! read, write or error callback moved out of its tracked socket to be executed (by the poll thread or by the callback workers), so that dispatching it requires neither a copy nor an allocation
+  //! given back to the tracked socket by complete_callback, unless it has been replaced in the meantime
+  //!  * service_latency: latency histograms of the io_service (null unless enabled when the callback has been dispatched)
+  //!  * socket_latency: latency histograms of the socket (null unless enabled)
+  //!  * event: event the callback is associated to (rd_event, wr_event or err_event)
+  //! members are ordered by decreasing alignment so that callback_task fits in the inline storage of task_t
+  //!
+  struct dispatched_callback {
+    event_callback_t callback;
+    std::uint64_t generation;
+    std::chrono::steady_clock::time_point reported_at;
+    latency_histograms* service_latency;
+    std::shared_ptr<latency_histograms> socket_latency;
+    fd_t fd;
+    int event;
+  };
+
+  //!
+  //! struct callback_task
+  //! task executing a dispatched callback on the callback workers (fits in the inline storage of task_t)
+  //!
+  struct callback_task {
+    dispatched_callback dispatched;
+    io_service* service;
+
+    //! execute the callback
+    void
+    operator()(void) {
+      service->execute_callback(dispatched, false);
+    }
   };
 
+private:
+  //!
+  //! \param fd fd of the socket
+  //! \return tracked_socket associated to the fd, created (with the io_service callback mode) if the socket is not tracked yet
+  //!
+  tracked_socket& get_tracked_socket(const fd_t& fd);
+
+  //!
+  //! remove the tracked_socket associated to the fd and complete its removal future, if any
+  //! must be called with m_tracked_sockets_mtx held
+  //!
+  //! \param fd fd of the socket
+  //!
+  void erase_tracked_socket(const fd_t& fd);
+
 private:
   //!
   //! poll worker function
@@ -167,40 +805,168 @@ private:
   void poll(void);
 
   //!
-  //! init m_poll_fds_info
-  //! simply initialize m_polled_fds variable based on m_tracked_sockets information
+  //! single iteration of the poll loop: wait for events, then process events, timers and posted tasks
   //!
-  //! \return maximum fd value polled
+  //! \param default_timeout_msecs timeout of the wait if no timer expires before (-1 for none)
   //!
-  int init_poll_fds_info(void);
+  void run_iteration(int default_timeout_msecs);
 
   //!
-  //! process poll detected events
-  //! called whenever select/poll completed to check read and write availablity
+  //! make the calling thread the one running the loop (loop_mode::caller_thread)
+  //! throws if the io_service runs in loop_mode::background_thread or if another thread is running the loop
   //!
-  void process_events(void);
+  void enter_loop(void);
+
+  //!
+  //! release the loop acquired by enter_loop
+  //!
+  void leave_loop(void);
 
   //!
-  //! process read event reported by select/poll for a given socket
+  //! register the socket in the poller if necessary and re-arm it for the events it should be polled for
+  //! that is, read (or write) if a read (or write) callback is defined and not currently being executed
+  //! must be called with m_tracked_sockets_mtx held, from the poll thread (or from track for the initial registration)
   //!
-  //! \param fd fd for which a read event has been reported
+  //! \param fd fd of the tracked socket
   //! \param socket tracked_socket associated to the given fd
   //!
-  void process_rd_event(const fd_t& fd, tracked_socket& socket);
+  void update_polled_events(const fd_t& fd, tracked_socket& socket);
 
   //!
-  //! process write event reported by select/poll for a given socket
+  //! queue the socket so that the poll thread calls update_polled_events for it before its next wait
+  //! must be called with m_tracked_sockets_mtx held, whenever the state of a tracked socket changes outside of the poll thread
+  //! wakes up the poll thread if the queue was empty (otherwise, a wake up is already on its way)
   //!
-  //! \param fd fd for which a write event has been reported
+  //! \param fd fd of the tracked socket
   //! \param socket tracked_socket associated to the given fd
   //!
-  void process_wr_event(const fd_t& fd, tracked_socket& socket);
+  void queue_polled_events_update(const fd_t& fd, tracked_socket& socket);
+
+  //!
+  //! wake up the poll thread
+  //! only the first call since the poll thread last cleared the notifier actually notifies it, the following ones are suppressed
+  //!
+  void wake_up(void);
+
+  //!
+  //! \param default_timeout_msecs timeout to be used if no timer expires before (-1 for none)
+  //! \return timeout to be used for the next wait on the poller
+  //!
+  int get_poll_timeout(int default_timeout_msecs);
+
+  //!
+  //! spin on non-blocking waits on the poller, according to the busy poll configuration
+  //!
+  //! \param default_timeout_msecs timeout to be used if no timer expires before (-1 for none), the spin never lasts longer than the timeout
+  //! \return true if events have been reported (in m_events), false if the blocking wait is still required
+  //!
+  bool busy_poll(int default_timeout_msecs);
+
+  //!
+  //! set SO_BUSY_POLL on a newly tracked socket, if configured
+  //!
+  //! \param fd fd of the socket
+  //!
+  void set_socket_busy_poll(const fd_t& fd);
+
+  //!
+  //! advance the timers and execute the callbacks of the expired ones
+  //! called by the poll thread after each wait
+  //!
+  void process_timers(void);
+
+  //!
+  //! execute the tasks queued by post
+  //! called by the poll thread after each wait
+  //!
+  void process_posted_tasks(void);
+
+  //!
+  //! execute a task on the poll thread, catching its exceptions
+  //!
+  //! \param task task to be executed
+  //!
+  void execute_task(const task_t& task);
+
+  //!
+  //! apply the updates queued by queue_polled_events_update
+  //! called by the poll thread before each wait
+  //!
+  void apply_pending_updates(void);
+
+  //!
+  //! process poll detected events
+  //! called whenever the poller reported events (or events were carried over) to check read and write availablity
+  //! dispatches up to m_max_events_per_iteration events, releasing m_tracked_sockets_mtx every __TACOPIE_IO_SERVICE_EVENTS_CHUNK_SIZE events
+  //!
+  void process_events(void);
+
+  //!
+  //! \return whether events are waiting to be dispatched (carried over from the previous iterations)
+  //!
+  bool has_ready_events(void) const;
+
+  //!
+  //! pop the next event to be dispatched: high priority events first, within the limit of the high priority share
+  //!
+  //! \return the next event to be dispatched (there must be one)
+  //!
+  ready_event pop_ready_event(void);
+
+  //!
+  //! lend the read, write or error callback of the socket and hand it over to the poll thread or to the callback workers, according to the socket callback mode
+  //!
+  //! \param fd fd of the socket
+  //! \param socket tracked_socket the callback belongs to
+  //! \param event event whose callback is dispatched (rd_event, wr_event or err_event)
+  //! \param reported_at time at which the poller reported the event
+  //!
+  void dispatch_callback(const fd_t& fd, tracked_socket& socket, int event, const std::chrono::steady_clock::time_point& reported_at);
+
+  //!
+  //! execute a dispatched callback, record its latency if enabled and complete it
+  //!
+  //! \param dispatched callback to be executed
+  //! \param from_poll_thread whether this function is called by the poll thread
+  //!
+  void execute_callback(dispatched_callback& dispatched, bool from_poll_thread);
+
+  //!
+  //! \return whether callbacks can be handed over to the callback workers (there is none in loop_mode::caller_thread, unless added by set_nb_workers)
+  //!
+  bool has_callback_workers(void) const;
+
+  //!
+  //! hand a callback of the given socket over to the callback workers, through the strand of the socket if any
+  //!
+  //! \param socket tracked_socket the callback belongs to
+  //! \param task task executing the callback
+  //!
+  void execute_on_workers(const tracked_socket& socket, task_t task);
+
+  //!
+  //! mark the callback as completed, and untrack or re-arm the socket accordingly
+  //! called once a read, write or error callback has been executed (by a callback worker or by the poll thread)
+  //!
+  //! \param fd fd of the socket
+  //! \param generation generation of the tracked socket when the callback has been dispatched
+  //! \param event event whose callback has been completed (rd_event, wr_event or err_event)
+  //! \param from_poll_thread whether this function is called by the poll thread
+  //! \param callback completed callback, moved back to the tracked socket unless it has been replaced in the meantime (left untouched otherwise, so that it is destroyed without m_tracked_sockets_mtx held)
+  //!
+  void complete_callback(const fd_t& fd, std::uint64_t generation, int event, bool from_poll_thread, event_callback_t& callback);
+
+  //!
+  //! execute the callbacks dispatched to the poll thread by process_events
+  //! called without m_tracked_sockets_mtx held, as callbacks are likely to call the io_service
+  //!
+  void execute_inline_callbacks(void);
 
 private:
   //!
-  //! tracked sockets
+  //! tracked sockets, indexed by fd
   //!
-  std::unordered_map<fd_t, tracked_socket> m_tracked_sockets;
+  utils::fd_table<tracked_socket> m_tracked_sockets;
 
   //!
   //! whether the worker should stop or not
@@ -208,44 +974,166 @@ private:
   std::atomic<bool> m_should_stop;
 
   //!
-  //! poll thread
+  //! how the poll loop is driven
+  //!
+  loop_mode m_loop_mode;
+
+  //!
+  //! poll thread (loop_mode::background_thread only)
   //!
   std::thread m_poll_worker;
 
+  //!
+  //! thread currently running the poll loop (default-constructed id if none)
+  //!
+  std::atomic<std::thread::id> m_loop_thread_id;
+
   //!
   //! callback workers
   //!
   utils::thread_pool m_callback_workers;
 
+  //!
+  //! callback mode applied to newly tracked sockets
+  //!
+  std::atomic<callback_mode> m_callback_mode;
+
+  //!
+  //! callbacks to be executed by the poll thread (see callback_mode::poll_thread)
+  //!
+  std::vector<dispatched_callback> m_inline_callbacks;
+
   //!
   //! thread safety
   //!
   std::mutex m_tracked_sockets_mtx;
 
   //!
-  //! data structure given to select (list of fds to poll)
+  //! readiness notification mechanism (select, poll, epoll or io_uring)
+  //!
+  std::unique_ptr<poller_iface> m_poller;
+
+  //!
+  //! events reported by the last wait on the poller
   //!
-  std::vector<fd_t> m_polled_fds;
+  std::vector<poller_iface::event> m_events;
 
   //!
-  //! data structure given to select (list of fds to poll for read)
+  //! events to be dispatched, including the ones carried over from the previous iterations
   //!
-  fd_set m_rd_set;
+  utils::ring_queue<ready_event> m_ready_events;
 
   //!
-  //! data structure given to select (list of fds to poll for write)
+  //! events of high priority sockets to be dispatched
   //!
-  fd_set m_wr_set;
+  utils::ring_queue<ready_event> m_high_priority_ready_events;
 
   //!
-  //! condition variable to wait on removal
+  //! maximum number of events dispatched per iteration (0 for no limit)
   //!
-  std::condition_variable m_wait_for_removal_condvar;
+  std::atomic<std::size_t> m_max_events_per_iteration;
+
+  //!
+  //! maximum number of high priority events dispatched in a row while normal priority events are pending
+  //!
+  std::atomic<std::size_t> m_high_priority_share;
+
+  //!
+  //! number of high priority events dispatched in a row while normal priority events were pending
+  //!
+  std::size_t m_nb_consecutive_high_priority_events;
+
+  //!
+  //! fds whose poller registration must be updated by the poll thread
+  //! swapped with m_applied_updates to be processed
+  //!
+  std::vector<fd_t> m_pending_updates;
+
+  //!
+  //! buffer in which the poll thread applies pending updates (kept to avoid reallocations)
+  //!
+  std::vector<fd_t> m_applied_updates;
+
+  //!
+  //! timers
+  //!
+  utils::timer_wheel m_timers;
+
+  //!
+  //! thread safety for m_timers and m_poll_deadline
+  //!
+  std::mutex m_timers_mtx;
+
+  //!
+  //! time until which the poll thread sleeps (min if it is awake, max if it sleeps with no timeout)
+  //! the poll thread must be woken up whenever a timer expiring before is scheduled
+  //!
+  utils::timer_wheel::clock_t::time_point m_poll_deadline;
+
+  //!
+  //! callbacks of the expired timers (kept to avoid reallocations)
+  //!
+  std::vector<utils::timer_wheel::callback_t> m_expired_timers;
+
+  //!
+  //! tasks posted to the poll thread
+  //!
+  utils::mpsc_queue<task_t> m_posted_tasks;
 
   //!
   //! fd associated to the pipe used to wake up the poll call
   //!
   tacopie::self_pipe m_notifier;
+
+  //!
+  //! whether the notifier has been notified and not yet cleared by the poll thread
+  //!
+  std::atomic<bool> m_wakeup_pending;
+
+  //!
+  //! wake up counters
+  //!
+  std::atomic<std::uint64_t> m_nb_wakeups;
+  std::atomic<std::uint64_t> m_nb_suppressed_wakeups;
+
+  //!
+  //! busy poll configuration (see set_busy_poll)
+  //!
+  std::atomic<std::uint32_t> m_busy_poll_spin_usecs;
+  std::atomic<std::uint32_t> m_busy_poll_max_spins;
+  std::atomic<std::uint32_t> m_socket_busy_poll_usecs;
+
+  //!
+  //! busy poll counters
+  //!
+  std::atomic<std::uint64_t> m_nb_busy_poll_hits;
+  std::atomic<std::uint64_t> m_nb_busy_poll_misses;
+
+  //!
+  //! loop statistics (see stats), only updated by the thread running the loop
+  //!
+  std::atomic<std::uint64_t> m_nb_iterations;
+  std::atomic<std::uint64_t> m_nb_events;
+  std::atomic<std::uint64_t> m_max_events_per_wakeup;
+  std::atomic<std::uint64_t> m_wait_time_nsecs;
+  std::atomic<std::uint64_t> m_processing_time_nsecs;
+  std::atomic<std::size_t> m_nb_carried_over_events;
+
+  //!
+  //! number of tracked sockets, readable without locking
+  //!
+  std::atomic<std::size_t> m_nb_tracked_sockets;
+
+  //!
+  //! time at which the last wait on the poller returned
+  //!
+  std::chrono::steady_clock::time_point m_last_wait_end;
+
+  //!
+  //! latency tracking
+  //!
+  std::atomic<bool> m_latency_tracking;
+  latency_histograms m_latency_histograms;
 };
 
 //!
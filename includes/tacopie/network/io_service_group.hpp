@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <tacopie/network/io_service.hpp>
+#include <tacopie/network/tcp_socket.hpp>
+#include <tacopie/utils/typedefs.hpp>
+
+namespace tacopie {
+
+//!
+//! group of independent io_service, each one running its own poll loop (and its own tracked sockets lock)
+//! each socket is assigned to one io_service of the group for its lifetime, based on an assignment policy
+//! this allows readiness processing to scale across cores
+//!
+class io_service_group {
+public:
+  //!
+  //! built-in policies used to assign sockets to the io_service of the group
+  //!
+  enum class assignment_policy {
+    //! io_services are assigned in turn
+    round_robin,
+    //! io_service tracking the fewest sockets
+    least_loaded,
+    //! io_service selected by hashing the fd of the socket
+    hash,
+    //! least loaded io_service among the ones pinned to the NUMA node of the cpu receiving the socket packets (the node owning the NIC queue)
+    //! falls back to least_loaded when the NUMA placement is unknown (poll threads not pinned, platform without SO_INCOMING_CPU or NUMA information)
+    numa_local
+  };
+
+  //!
+  //! custom assignment policy
+  //! returns the index of the io_service (in the given vector) to which the socket must be assigned
+  //!
+  typedef std::function<std::size_t(fd_t fd, const std::vector<std::shared_ptr<io_service>>& services)> assignment_policy_t;
+
+public:
+  //!
+  //! ctor, io_services use the default poller (__TACOPIE_DEFAULT_POLLER)
+  //!
+  //! \param nb_services number of io_service in the group, 0 means one per cpu the process is allowed to run on (see utils::get_allowed_cpus)
+  //! \param policy policy used to assign sockets to the io_services
+  //! \param pin_poll_threads whether the poll thread of the i-th io_service should be pinned to the i-th allowed cpu (modulo the number of allowed cpus)
+  //!                         the callback workers of the io_service are then restricted to the allowed cpus of the same NUMA node
+  //!                         pinning failures are logged as warnings, the threads are then left unpinned
+  //!
+  explicit io_service_group(std::size_t nb_services = 0, assignment_policy policy = assignment_policy::round_robin, bool pin_poll_threads = false);
+
+  //!
+  //! ctor
+  //!
+  //! \param nb_services number of io_service in the group, 0 means one per cpu the process is allowed to run on (see utils::get_allowed_cpus)
+  //! \param policy policy used to assign sockets to the io_services
+  //! \param pin_poll_threads whether the poll thread of the i-th io_service should be pinned to the i-th allowed cpu (modulo the number of allowed cpus)
+  //!                         the callback workers of the io_service are then restricted to the allowed cpus of the same NUMA node
+  //!                         pinning failures are logged as warnings, the threads are then left unpinned
+  //! \param type poller used by the io_services
+  //!
+  io_service_group(std::size_t nb_services, assignment_policy policy, bool pin_poll_threads, poller_type type);
+
+  //! dtor
+  ~io_service_group(void) = default;
+
+  //! copy ctor
+  io_service_group(const io_service_group&) = delete;
+  //! assignment operator
+  io_service_group& operator=(const io_service_group&) = delete;
+
+public:
+  //!
+  //! change the policy used to assign sockets (already assigned sockets are not affected)
+  //!
+  //! \param policy built-in policy
+  //!
+  void set_assignment_policy(assignment_policy policy);
+
+  //!
+  //! change the policy used to assign sockets (already assigned sockets are not affected)
+  //!
+  //! \param policy custom policy
+  //!
+  void set_assignment_policy(const assignment_policy_t& policy);
+
+public:
+  //!
+  //! assign a socket to one of the io_services of the group
+  //!
+  //! \param socket socket to be assigned
+  //! \return io_service to be used for the socket
+  //!
+  const std::shared_ptr<io_service>& get_io_service(const tcp_socket& socket);
+
+  //!
+  //! \return io_services of the group
+  //!
+  const std::vector<std::shared_ptr<io_service>>& get_io_services(void) const;
+
+  //!
+  //! \return NUMA node of the i-th io_service poll thread, -1 if unknown (poll thread not pinned)
+  //!
+  const std::vector<int>& get_io_services_numa_nodes(void) const;
+
+private:
+  //!
+  //! least loaded io_service, among the ones accepted by the filter
+  //!
+  //! \param services io_services to select from
+  //! \param filter returns whether the i-th io_service can be selected
+  //! \return index of the selected io_service, services.size() if none is accepted by the filter
+  //!
+  static std::size_t least_loaded_io_service(const std::vector<std::shared_ptr<io_service>>& services, const std::function<bool(std::size_t)>& filter);
+
+private:
+  //!
+  //! io_services of the group
+  //!
+  std::vector<std::shared_ptr<io_service>> m_io_services;
+
+  //!
+  //! NUMA node of each io_service poll thread (-1 if unknown)
+  //!
+  std::vector<int> m_io_services_numa_nodes;
+
+  //!
+  //! current assignment policy
+  //!
+  assignment_policy_t m_policy;
+
+  //!
+  //! next io_service to be assigned by the round robin policy
+  //!
+  std::atomic<std::size_t> m_next_io_service;
+
+  //!
+  //! thread safety for m_policy
+  //!
+  std::mutex m_policy_mtx;
+};
+
+} // namespace tacopie
@@ -0,0 +1,408 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && __has_include(<linux/time_types.h>)
+#include <linux/io_uring.h>
+
+//! completion-based operations require the linux 5.7 headers (fast poll)
+#ifdef IORING_FEAT_FAST_POLL
+#define __TACOPIE_HAS_IO_URING
+#endif /* IORING_FEAT_FAST_POLL */
+#endif /* __has_include(<linux/io_uring.h>) && __has_include(<linux/time_types.h>) */
+#endif /* __linux__ && __has_include */
+
+#ifdef __TACOPIE_HAS_IO_URING
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <linux/time_types.h>
+#include <sys/socket.h>
+
+#include <tacopie/network/poller.hpp>
+
+namespace tacopie {
+
+//!
+//! io_uring based poller, linux only
+//! fds are polled with one-shot poll requests, which matches the one-shot semantic of poller_iface without any extra syscall to disarm them.
+//! requests issued from the polling thread (re-arming fds after dispatching events) are batched and submitted by the same io_uring_enter call that waits for the completions.
+//!
+//! recv, send and accept can also be submitted as completion-based operations (see poller_iface::supports_completions), saving the syscall that follows each readiness event.
+//! they are supported if the kernel provides the recv, send, accept and cancel operations along with fast poll (linux 5.7), so that waiting operations do not hold kernel worker threads.
+//!
+//! the constructor throws if the kernel does not support io_uring (or if it is disabled).
+//!
+class io_uring_poller : public poller_iface {
+public:
+  //!
+  //! ctor
+  //!
+  //! \param nb_entries size of the submission queue
+  //!
+  explicit io_uring_poller(unsigned int nb_entries = 1024);
+  //! dtor
+  ~io_uring_poller(void);
+
+  //! copy ctor
+  io_uring_poller(const io_uring_poller&) = delete;
+  //! assignment operator
+  io_uring_poller& operator=(const io_uring_poller&) = delete;
+
+public:
+  //!
+  //! register a fd
+  //!
+  //! \param fd fd to be polled
+  //! \param events combination of event_type to poll for
+  //! \param persistent if true, the fd is never disarmed when an event is reported
+  //!
+  void add(fd_t fd, int events, bool persistent);
+
+  //!
+  //! update (and re-arm) the interest of a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  void modify(fd_t fd, int events);
+
+  //!
+  //! unregister a fd
+  //!
+  //! \param fd registered fd
+  //!
+  void remove(fd_t fd);
+
+  //!
+  //! wait for events
+  //!
+  //! \param events vector filled with the reported events (cleared first)
+  //! \param timeout_msecs maximum time to wait, -1 to block until an event is reported
+  //!
+  void wait(std::vector<event>& events, int timeout_msecs);
+
+public:
+  //!
+  //! \return whether completion-based operations are supported by the kernel
+  //!
+  bool supports_completions(void) const;
+
+  //!
+  //! submit a recv of up to size bytes on a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param size maximum number of bytes to receive
+  //!
+  void submit_recv(fd_t fd, std::size_t size);
+
+  //!
+  //! submit a send of the given bytes on a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param buffer bytes to be sent
+  //! \param token value returned along with the result of the send
+  //!
+  void submit_send(fd_t fd, std::vector<char> buffer, std::uint64_t token);
+
+  //!
+  //! submit an accept on a registered listening fd
+  //!
+  //! \param fd registered fd
+  //!
+  void submit_accept(fd_t fd);
+
+  //!
+  //! take the result of a completed operation
+  //!
+  //! \param fd registered fd
+  //! \param event rd_event for the recv or accept, wr_event for the send
+  //! \param max_size maximum number of received bytes to take (recv only)
+  //! \param result filled with the result of the operation
+  //! \return false if no operation of this direction has completed
+  //!
+  bool take_completion(fd_t fd, int event, std::size_t max_size, completion& result);
+
+public:
+  //!
+  //! \return the type of the poller
+  //!
+  poller_type get_type(void) const;
+
+private:
+  //!
+  //! struct operation
+  //! recv, send or accept submitted on a fd
+  //! allocated once per fd and direction and reused, its address must remain stable while the kernel may write to it (buffer and addr_len)
+  //!  * opcode: IORING_OP_RECV, IORING_OP_SEND or IORING_OP_ACCEPT
+  //!  * id: user_data of the request in flight, 0 if the operation is not in progress
+  //!  * is_completed: whether the operation completed and its result has not been taken yet
+  //!  * result: cqe result of the completed operation
+  //!  * buffer: received bytes, bytes to be sent, or address of the peer
+  //!  * offset: received bytes already taken
+  //!  * token: token of the send
+  //!  * addr_len: length of the address of the peer
+  //!
+  struct operation {
+    int opcode;
+    std::uint64_t id;
+    bool is_completed;
+    int result;
+    std::vector<char> buffer;
+    std::size_t offset;
+    std::uint64_t token;
+    socklen_t addr_len;
+  };
+
+  //!
+  //! struct registration
+  //! contains information about a registered fd
+  //!  * events: events the fd is polled for
+  //!  * persistent: whether the fd must be re-armed after each reported event
+  //!  * poll_id: user_data of the poll request in flight, 0 if the fd is disarmed
+  //!  * poll_events: events the poll request in flight is polling for
+  //!  * armed_completions: directions (rd_event, wr_event) whose completion is reported as soon as available
+  //!  * rd_operation: recv or accept (null until the first one is submitted)
+  //!  * wr_operation: send (null until the first one is submitted)
+  //!
+  struct registration {
+    //! polled events
+    int events;
+    //! persistent
+    bool persistent;
+    //! poll request in flight
+    std::uint64_t poll_id;
+    int poll_events;
+    //! completion-based operations
+    int armed_completions;
+    std::unique_ptr<operation> rd_operation;
+    std::unique_ptr<operation> wr_operation;
+  };
+
+private:
+  //!
+  //! queue a poll request for the given fd, must be called with m_ring_mtx held
+  //!
+  //! \param fd fd to be polled
+  //! \param reg registration associated to the fd
+  //!
+  void arm(fd_t fd, registration& reg);
+
+  //!
+  //! queue the cancellation of the poll request in flight for the given fd (if any), must be called with m_ring_mtx held
+  //!
+  //! \param reg registration associated to the fd
+  //!
+  void disarm(registration& reg);
+
+  //!
+  //! arm the fd according to its registration, must be called with m_ring_mtx held
+  //! polls for the events that are not handled by an operation, and queues the report of the completed operations the fd is armed for
+  //! called whenever the interest of the fd or the state of its operations changes
+  //!
+  //! \param fd registered fd
+  //! \param reg registration associated to the fd
+  //!
+  void update(fd_t fd, registration& reg);
+
+  //!
+  //! \param fd registered fd
+  //! \return registration of the fd, throws if the fd is not registered or if completions are not supported
+  //! must be called with m_ring_mtx held
+  //!
+  registration& get_registration_for_operation(fd_t fd);
+
+  //!
+  //! queue an operation request, must be called with m_ring_mtx held
+  //!
+  //! \param fd fd the operation is submitted on
+  //! \param op operation to be submitted (opcode and buffer set)
+  //!
+  void submit_operation(fd_t fd, operation& op);
+
+  //!
+  //! queue the cancellation of an operation in progress (if any), must be called with m_ring_mtx held
+  //! the operation is kept alive until its completion is received
+  //!
+  //! \param op operation to be cancelled (may be null)
+  //!
+  void cancel_operation(std::unique_ptr<operation>& op);
+
+  //!
+  //! \return a new user_data for a request on the given fd
+  //!
+  //! \param fd fd of the request
+  //!
+  std::uint64_t get_next_request_id(fd_t fd);
+
+  //!
+  //! process a completion entry, must be called with m_ring_mtx held
+  //!
+  //! \param cqe completion entry
+  //! \param events vector to which reported events are appended
+  //!
+  void process_cqe(const struct io_uring_cqe& cqe, std::vector<event>& events);
+
+  //!
+  //! cancel the operations in progress and wait for their completion, so that the kernel stops using their buffers
+  //! called on destruction
+  //!
+  void cancel_all_operations(void);
+
+  //!
+  //! \return whether the kernel provides the operations required by completion-based operations
+  //!
+  bool probe_completions_support(void);
+
+  //!
+  //! \param op operation (may be null)
+  //! \return whether the operation is in progress or waiting to be taken (readiness of its direction is then not polled for)
+  //!
+  static bool is_operation_pending(const std::unique_ptr<operation>& op);
+
+  //!
+  //! get a free submission queue entry, submitting the queued ones if the queue is full
+  //! must be called with m_ring_mtx held
+  //!
+  //! \return zero-initialized sqe to be filled and committed with commit_sqe
+  //!
+  struct io_uring_sqe* get_sqe(void);
+
+  //!
+  //! make a filled sqe visible to the kernel, must be called with m_ring_mtx held
+  //!
+  void commit_sqe(void);
+
+  //!
+  //! \return number of sqes committed but not consumed by the kernel yet
+  //!
+  unsigned int get_nb_unsubmitted_sqes(void) const;
+
+  //!
+  //! submit queued sqes right away, unless called from the polling thread (in which case they will be submitted on next wait)
+  //! must be called with m_ring_mtx held
+  //!
+  void submit_if_not_polling_thread(void);
+
+  //!
+  //! submit queued sqes and wait for completions
+  //!
+  //! \param to_submit number of sqes to submit
+  //! \param min_complete number of completions to wait for
+  //! \return io_uring_enter result
+  //!
+  int enter(unsigned int to_submit, unsigned int min_complete);
+
+  //!
+  //! unmap the rings and close the io_uring instance
+  //!
+  void release(void);
+
+private:
+  //!
+  //! io_uring instance
+  //!
+  fd_t m_ring_fd;
+
+  //!
+  //! mmaped rings (sq & cq rings may share the same mapping)
+  //!
+  void* m_sq_ring;
+  std::size_t m_sq_ring_size;
+  void* m_cq_ring;
+  std::size_t m_cq_ring_size;
+
+  //!
+  //! submission queue
+  //!
+  struct io_uring_sqe* m_sqes;
+  std::size_t m_sqes_size;
+  unsigned int* m_sq_head;
+  unsigned int* m_sq_tail;
+  unsigned int* m_sq_mask;
+  unsigned int* m_sq_array;
+  unsigned int m_sq_entries;
+
+  //!
+  //! completion queue
+  //!
+  struct io_uring_cqe* m_cqes;
+  unsigned int* m_cq_head;
+  unsigned int* m_cq_tail;
+  unsigned int* m_cq_mask;
+
+  //!
+  //! registered fds
+  //!
+  std::unordered_map<fd_t, registration> m_fds;
+
+  //!
+  //! persistent fds reported by the last wait, to be re-armed on next wait
+  //!
+  std::vector<fd_t> m_persistent_fds_to_rearm;
+
+  //!
+  //! completions to be reported by the next wait (operations that completed while their fd was not armed)
+  //!
+  std::vector<event> m_completions_to_report;
+
+  //!
+  //! cancelled operations, kept alive until their completion is received
+  //!
+  std::unordered_map<std::uint64_t, std::unique_ptr<operation>> m_cancelled_operations;
+
+  //!
+  //! whether completion-based operations are supported
+  //!
+  bool m_supports_completions;
+
+  //!
+  //! sequence number of the next request, combined with the fd to build its user_data
+  //!
+  std::uint32_t m_next_request_seq;
+
+  //!
+  //! timeout given to the timeout request, must outlive its submission
+  //!
+  struct __kernel_timespec m_timeout;
+
+  //!
+  //! thread calling wait
+  //!
+  std::thread::id m_polling_thread_id;
+
+  //!
+  //! thread safety (fds can be updated while waiting)
+  //!
+  std::mutex m_ring_mtx;
+};
+
+} // namespace tacopie
+
+#endif /* __TACOPIE_HAS_IO_URING */
@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <mutex>
+#include <unordered_map>
+
+#include <poll.h>
+
+#include <tacopie/network/poller.hpp>
+
+namespace tacopie {
+
+//!
+//! poll() based poller, available on unix platforms
+//! not limited by FD_SETSIZE, but its cost is still proportional to the number of registered fds
+//!
+class poll_poller : public poller_iface {
+public:
+  //! ctor
+  poll_poller(void);
+  //! dtor
+  ~poll_poller(void) = default;
+
+  //! copy ctor
+  poll_poller(const poll_poller&) = delete;
+  //! assignment operator
+  poll_poller& operator=(const poll_poller&) = delete;
+
+public:
+  //!
+  //! register a fd
+  //!
+  //! \param fd fd to be polled
+  //! \param events combination of event_type to poll for
+  //! \param persistent if true, the fd is never disarmed when an event is reported
+  //!
+  void add(fd_t fd, int events, bool persistent);
+
+  //!
+  //! update (and re-arm) the interest of a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  void modify(fd_t fd, int events);
+
+  //!
+  //! unregister a fd
+  //!
+  //! \param fd registered fd
+  //!
+  void remove(fd_t fd);
+
+  //!
+  //! wait for events
+  //!
+  //! \param events vector filled with the reported events (cleared first)
+  //! \param timeout_msecs maximum time to wait, -1 to block until an event is reported
+  //!
+  void wait(std::vector<event>& events, int timeout_msecs);
+
+public:
+  //!
+  //! \return the type of the poller
+  //!
+  poller_type get_type(void) const;
+
+private:
+  //!
+  //! update the pollfd entry at the given index
+  //! disarmed entries get a negative fd so that poll() does not report POLLERR/POLLHUP for them
+  //!
+  //! \param index index of the entry in m_pollfds
+  //! \param events combination of event_type to poll for
+  //!
+  void set_fd_events(std::size_t index, int events);
+
+private:
+  //!
+  //! master pollfd array, copied before each call to poll
+  //!
+  std::vector<struct pollfd> m_pollfds;
+
+  //!
+  //! registered fds, in the same order than m_pollfds (m_pollfds[i].fd is negative when the fd is disarmed)
+  //!
+  std::vector<fd_t> m_fds;
+
+  //!
+  //! whether the fds are persistent, in the same order than m_pollfds
+  //!
+  std::vector<bool> m_persistent;
+
+  //!
+  //! index of each registered fd in m_pollfds
+  //!
+  std::unordered_map<fd_t, std::size_t> m_indexes;
+
+  //!
+  //! thread safety (fds can be updated while poll is running)
+  //!
+  std::mutex m_fds_mtx;
+};
+
+} // namespace tacopie
+
+#endif /* _WIN32 */
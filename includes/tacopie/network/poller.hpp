@@ -0,0 +1,238 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <tacopie/utils/typedefs.hpp>
+
+#ifndef __TACOPIE_DEFAULT_POLLER
+#ifdef __linux__
+#define __TACOPIE_DEFAULT_POLLER epoll
+#else
+#define __TACOPIE_DEFAULT_POLLER select
+#endif /* __linux__ */
+#endif /* __TACOPIE_DEFAULT_POLLER */
+
+namespace tacopie {
+
+//!
+//! readiness notification mechanisms that can be used by the io_service
+//! the default one can be chosen at compile time by defining __TACOPIE_DEFAULT_POLLER (epoll on linux, select otherwise)
+//!
+enum class poller_type {
+  //! select(), available everywhere, limited to FD_SETSIZE fds
+  select,
+  //! poll(), unix only
+  poll,
+  //! epoll, linux only
+  epoll,
+  //! io_uring, recent linux kernels only
+  io_uring
+};
+
+//!
+//! poller_iface
+//! should be inherited by any readiness notification mechanism used by the io_service (select, epoll, ...)
+//!
+//! fds are registered once and their interest is then updated incrementally.
+//! interests are one-shot: once an event has been reported for a fd, the fd is disarmed until modify() is called again.
+//! this way, a fd for which a callback is being executed does not need to be explicitly disabled.
+//!
+//! add, modify and remove may be called concurrently with wait.
+//!
+//! some mechanisms (io_uring) also support completion-based operations, see supports_completions.
+//!
+class poller_iface {
+public:
+  //!
+  //! events a fd can be polled for, and events reported by wait
+  //! err_event stands for errors and hangups (POLLERR, POLLHUP), which are always reported as read & write availability too
+  //! hup_event is only reported, for fds polled for err_event: the peer shut its side of the connection down (EPOLLRDHUP, POLLRDHUP), data may still be buffered
+  //! both are level triggered, and not supported by every mechanism (see select_poller)
+  //!
+  enum event_type {
+    no_event  = 0x0,
+    rd_event  = 0x1,
+    wr_event  = 0x2,
+    err_event = 0x4,
+    hup_event = 0x8
+  };
+
+  //!
+  //! event reported by wait
+  //!  * fd: fd for which the event has been reported
+  //!  * events: combination of event_type
+  //!
+  struct event {
+    //!
+    //! fd for which the event has been reported
+    //!
+    fd_t fd;
+    //!
+    //! reported events
+    //!
+    int events;
+  };
+
+  //!
+  //! result of a completion-based operation, see take_completion
+  //!  * result: number of bytes received (0 if the peer closed the connection) or sent, fd of the accepted connection, or -errno on failure
+  //!  * buffer: received bytes (recv), or address of the peer (accept, as a struct sockaddr_storage)
+  //!  * token: token given to submit_send (send)
+  //!
+  struct completion {
+    //!
+    //! result of the operation
+    //!
+    int result;
+    //!
+    //! received bytes or address of the peer
+    //!
+    std::vector<char> buffer;
+    //!
+    //! token of the send operation
+    //!
+    std::uint64_t token;
+  };
+
+public:
+  //! ctor
+  poller_iface(void) = default;
+  //! dtor
+  virtual ~poller_iface(void) = default;
+
+  //! copy ctor
+  poller_iface(const poller_iface&) = delete;
+  //! assignment operator
+  poller_iface& operator=(const poller_iface&) = delete;
+
+public:
+  //!
+  //! register a fd
+  //!
+  //! \param fd fd to be polled
+  //! \param events combination of event_type to poll for
+  //! \param persistent if true, the fd is never disarmed when an event is reported (used for the notifier)
+  //!
+  virtual void add(fd_t fd, int events, bool persistent) = 0;
+
+  //!
+  //! update (and re-arm) the interest of a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  virtual void modify(fd_t fd, int events) = 0;
+
+  //!
+  //! unregister a fd
+  //!
+  //! \param fd registered fd
+  //!
+  virtual void remove(fd_t fd) = 0;
+
+  //!
+  //! wait for events
+  //!
+  //! \param events vector filled with the reported events (cleared first)
+  //! \param timeout_msecs maximum time to wait, -1 to block until an event is reported
+  //!
+  virtual void wait(std::vector<event>& events, int timeout_msecs) = 0;
+
+public:
+  //!
+  //! completion-based operations
+  //! instead of reporting a socket as readable (or writable), the poller performs the recv or accept (or send) itself, and reports the socket with rd_event (or wr_event) once the operation completed
+  //! the result of the operation is then taken with take_completion
+  //! a single operation per direction can be in progress for a fd: read and write readiness are not polled for while an operation of the same direction is in progress or waiting to be taken
+  //! completions are one-shot as readiness events: a completion is reported if the fd is armed for its direction, otherwise it is reported once the fd is armed again (and until it is taken)
+  //! operations in progress are cancelled when the fd is removed
+  //!
+  //! these functions can be called from any thread, and throw unless supports_completions returns true
+  //!
+
+  //!
+  //! \return whether completion-based operations are supported (false by default)
+  //!
+  virtual bool supports_completions(void) const;
+
+  //!
+  //! submit a recv of up to size bytes on a registered fd
+  //! does nothing if a recv is already in progress or if received bytes have not been taken yet
+  //!
+  //! \param fd registered fd
+  //! \param size maximum number of bytes to receive
+  //!
+  virtual void submit_recv(fd_t fd, std::size_t size);
+
+  //!
+  //! submit a send of the given bytes on a registered fd
+  //! throws if a send is already in progress or if the result of the previous one has not been taken yet
+  //!
+  //! \param fd registered fd
+  //! \param buffer bytes to be sent, kept by the poller until the send completes
+  //! \param token value returned along with the result of the send, to identify it
+  //!
+  virtual void submit_send(fd_t fd, std::vector<char> buffer, std::uint64_t token);
+
+  //!
+  //! submit an accept on a registered listening fd
+  //! does nothing if an accept is already in progress or if the accepted connection has not been taken yet
+  //!
+  //! \param fd registered fd
+  //!
+  virtual void submit_accept(fd_t fd);
+
+  //!
+  //! take the result of a completed operation
+  //! received bytes beyond max_size are kept for the next take (and reported again once the fd is armed for read)
+  //!
+  //! \param fd registered fd
+  //! \param event rd_event for the recv or accept, wr_event for the send
+  //! \param max_size maximum number of received bytes to take (recv only)
+  //! \param result filled with the result of the operation
+  //! \return false if no operation of this direction has completed
+  //!
+  virtual bool take_completion(fd_t fd, int event, std::size_t max_size, completion& result);
+
+public:
+  //!
+  //! \return the type of the poller
+  //!
+  virtual poller_type get_type(void) const = 0;
+};
+
+//!
+//! create a poller of the requested type
+//! if the type is not available on this platform (or not supported by the kernel), falls back to the closest available one: io_uring, then epoll, then poll and finally select
+//!
+//! \param type type of the poller to be created
+//! \return created poller
+//!
+std::unique_ptr<poller_iface> create_poller(poller_type type);
+
+} // namespace tacopie
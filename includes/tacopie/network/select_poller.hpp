@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif /* _WIN32 */
+
+#include <tacopie/network/poller.hpp>
+
+namespace tacopie {
+
+//!
+//! select() based poller, available on all platforms
+//! limited to FD_SETSIZE fds and its cost is proportional to the number of registered fds
+//! err_event is not supported (ignored): the exception set only reports out-of-band data (and connection failures on windows), not errors nor hangups
+//! errors and hangups are then only noticed through read or write availability, once an operation is pending
+//!
+class select_poller : public poller_iface {
+public:
+  //! ctor
+  select_poller(void);
+  //! dtor
+  ~select_poller(void) = default;
+
+  //! copy ctor
+  select_poller(const select_poller&) = delete;
+  //! assignment operator
+  select_poller& operator=(const select_poller&) = delete;
+
+public:
+  //!
+  //! register a fd
+  //!
+  //! \param fd fd to be polled
+  //! \param events combination of event_type to poll for
+  //! \param persistent if true, the fd is never disarmed when an event is reported
+  //!
+  void add(fd_t fd, int events, bool persistent);
+
+  //!
+  //! update (and re-arm) the interest of a registered fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  void modify(fd_t fd, int events);
+
+  //!
+  //! unregister a fd
+  //!
+  //! \param fd registered fd
+  //!
+  void remove(fd_t fd);
+
+  //!
+  //! wait for events
+  //!
+  //! \param events vector filled with the reported events (cleared first)
+  //! \param timeout_msecs maximum time to wait, -1 to block until an event is reported
+  //!
+  void wait(std::vector<event>& events, int timeout_msecs);
+
+public:
+  //!
+  //! \return the type of the poller
+  //!
+  poller_type get_type(void) const;
+
+private:
+  //!
+  //! update m_rd_set and m_wr_set for the given fd
+  //!
+  //! \param fd registered fd
+  //! \param events combination of event_type to poll for
+  //!
+  void set_fd_events(fd_t fd, int events);
+
+private:
+  //!
+  //! registered fds and whether they are persistent
+  //!
+  std::unordered_map<fd_t, bool> m_fds;
+
+  //!
+  //! master set of fds polled for read, copied before each call to select
+  //!
+  fd_set m_rd_set;
+
+  //!
+  //! master set of fds polled for write, copied before each call to select
+  //!
+  fd_set m_wr_set;
+
+  //!
+  //! thread safety (fds can be updated while select is running)
+  //!
+  std::mutex m_fds_mtx;
+};
+
+} // namespace tacopie
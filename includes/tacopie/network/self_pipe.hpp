@@ -29,6 +29,7 @@ namespace tacopie {
 //!
 //! used to force poll to wake up
 //! simply make poll watch for read events on one side of the pipe and write to the other side
+//! on linux, an eventfd is used instead of a pipe whenever available (read and write fds are then the same)
 //!
 class self_pipe {
 public:
@@ -81,9 +82,14 @@ private:
   int m_addr_len;
 #else
   //!
-  //! pipe file descriptors
+  //! pipe file descriptors (both set to the eventfd if m_is_eventfd)
   //!
   fd_t m_fds[2];
+
+  //!
+  //! whether an eventfd is used instead of a pipe
+  //!
+  bool m_is_eventfd;
 #endif /* _WIN32 */
 };
 
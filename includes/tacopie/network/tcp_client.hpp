@@ -23,12 +23,15 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 
 #include <tacopie/network/io_service.hpp>
+#include <tacopie/network/io_service_group.hpp>
 #include <tacopie/network/tcp_socket.hpp>
 #include <tacopie/utils/typedefs.hpp>
 
@@ -52,6 +55,23 @@ public:
   //!
   explicit tcp_client(tcp_socket&& socket);
 
+  //!
+  //! custom ctor
+  //! build socket from existing socket, tracked by the given io_service
+  //!
+  //! \param socket tcp_socket instance to be used for building the client (socket will be moved)
+  //! \param service io_service tracking the socket
+  //!
+  tcp_client(tcp_socket&& socket, const std::shared_ptr<io_service>& service);
+
+  //!
+  //! custom ctor
+  //! the socket is assigned to one of the io_services of the group on connection
+  //!
+  //! \param group io_service_group used to assign the socket
+  //!
+  explicit tcp_client(const std::shared_ptr<io_service_group>& group);
+
   //! copy ctor
   tcp_client(const tcp_client&) = delete;
   //! assignment operator
@@ -114,8 +134,9 @@ private:
 public:
   //!
   //! structure to store read requests result
-  //!  * success: Whether the read operation has succeeded or not. If false, the client has been disconnected
+  //!  * success: Whether the read operation has succeeded or not. If false, the client has been disconnected (unless timed_out is set)
   //!  * buffer: Vector containing the read bytes
+  //!  * timed_out: Whether the operation failed because its deadline expired
   //!
   struct read_result {
     //!
@@ -126,12 +147,17 @@ public:
     //! read bytes
     //!
     std::vector<char> buffer;
+    //!
+    //! whether the operation timed out
+    //!
+    bool timed_out;
   };
 
   //!
   //! structure to store write requests result
-  //!  * success: Whether the write operation has succeeded or not. If false, the client has been disconnected
+  //!  * success: Whether the write operation has succeeded or not. If false, the client has been disconnected (unless timed_out is set)
   //!  * size: Number of bytes written
+  //!  * timed_out: Whether the operation failed because its deadline expired
   //!
   struct write_result {
     //!
@@ -142,28 +168,43 @@ public:
     //! number of bytes written
     //!
     std::size_t size;
+    //!
+    //! whether the operation timed out
+    //!
+    bool timed_out;
   };
 
 public:
   //!
   //! callback to be called on async read completion
   //! takes the read_result as a parameter
+  //! move-only, stored inline (without allocation) if it fits in __TACOPIE_SMALL_FUNCTION_SIZE bytes
   //!
-  typedef std::function<void(read_result&)> async_read_callback_t;
+  typedef utils::small_function<void(read_result&)> async_read_callback_t;
 
   //!
   //! callback to be called on async write completion
   //! takes the write_result as a parameter
+  //! move-only, stored inline (without allocation) if it fits in __TACOPIE_SMALL_FUNCTION_SIZE bytes
   //!
-  typedef std::function<void(write_result&)> async_write_callback_t;
+  typedef utils::small_function<void(write_result&)> async_write_callback_t;
 
 public:
   //!
   //! structure to store read requests information
   //!  * size: Number of bytes to read
   //!  * async_read_callback: Callback to be called on a read operation completion, even though the operation read less bytes than requested.
+  //!  * timeout_msecs: Deadline of the operation (0 means no deadline). On expiry, the callback is called with timed_out set.
+  //!  * disconnect_on_timeout: Whether the client should be disconnected when the deadline expires
   //!
   struct read_request {
+    //! ctor
+    read_request(std::size_t size = 0, async_read_callback_t async_read_callback = nullptr, std::uint32_t timeout_msecs = 0, bool disconnect_on_timeout = false)
+    : size(size)
+    , async_read_callback(std::move(async_read_callback))
+    , timeout_msecs(timeout_msecs)
+    , disconnect_on_timeout(disconnect_on_timeout) {}
+
     //!
     //! number of bytes to read
     //!
@@ -172,14 +213,31 @@ public:
     //! callback to be executed on read operation completion
     //!
     async_read_callback_t async_read_callback;
+    //!
+    //! deadline of the operation, 0 for none
+    //!
+    std::uint32_t timeout_msecs;
+    //!
+    //! whether to disconnect on timeout
+    //!
+    bool disconnect_on_timeout;
   };
 
   //!
   //! structure to store write requests information
   //!  * buffer: Bytes to be written
   //!  * async_write_callback: Callback to be called on a write operation completion, even though the operation wrote less bytes than requested.
+  //!  * timeout_msecs: Deadline of the operation (0 means no deadline). On expiry, the callback is called with timed_out set.
+  //!  * disconnect_on_timeout: Whether the client should be disconnected when the deadline expires
   //!
   struct write_request {
+    //! ctor
+    write_request(std::vector<char> buffer = {}, async_write_callback_t async_write_callback = nullptr, std::uint32_t timeout_msecs = 0, bool disconnect_on_timeout = false)
+    : buffer(std::move(buffer))
+    , async_write_callback(std::move(async_write_callback))
+    , timeout_msecs(timeout_msecs)
+    , disconnect_on_timeout(disconnect_on_timeout) {}
+
     //!
     //! bytes to write
     //!
@@ -188,22 +246,32 @@ public:
     //! callback to be executed on write operation completion
     //!
     async_write_callback_t async_write_callback;
+    //!
+    //! deadline of the operation, 0 for none
+    //!
+    std::uint32_t timeout_msecs;
+    //!
+    //! whether to disconnect on timeout
+    //!
+    bool disconnect_on_timeout;
   };
 
 public:
   //!
   //! async read operation
+  //! requests are move-only (as their callback): named requests must be std::move'd
   //!
   //! \param request read request information
   //!
-  void async_read(const read_request& request);
+  void async_read(read_request request);
 
   //!
   //! async write operation
+  //! requests are move-only (as their callback): named requests must be std::move'd
   //!
   //! \param request write request information
   //!
-  void async_write(const write_request& request);
+  void async_write(write_request request);
 
 public:
   //!
@@ -222,6 +290,36 @@ public:
   //!
   const std::shared_ptr<tacopie::io_service>& get_io_service(void) const;
 
+public:
+  //!
+  //! execute the read, write and timeout callbacks of the client through a strand, so that they never run concurrently
+  //! tasks posted to the same strand (for instance through get_strand) are serialized with them, so that the state of the connection can be handled without locks
+  //! the strand is applied right away if the client is connected, on connection otherwise: it should be set before issuing any request
+  //!
+  //! \param strand strand executing the callbacks (typically get_io_service()->make_strand(), nullptr to stop using a strand)
+  //!
+  void set_strand(const std::shared_ptr<utils::strand>& strand);
+
+  //!
+  //! \return strand executing the callbacks of the client (null if none)
+  //!
+  const std::shared_ptr<utils::strand>& get_strand(void) const;
+
+public:
+  //!
+  //! set the priority of the client: the events and callbacks of high priority clients are processed ahead of the normal priority ones (see io_service::set_priority)
+  //! the priority is applied right away if the client is connected, on connection otherwise
+  //! if the client uses a strand, the strand should be created with the same priority
+  //!
+  //! \param client_priority priority of the client (normal by default)
+  //!
+  void set_priority(io_service::priority client_priority);
+
+  //!
+  //! \return priority of the client
+  //!
+  io_service::priority get_priority(void) const;
+
 public:
   //!
   //! disconnection handle
@@ -254,6 +352,66 @@ private:
   //!
   void on_write_available(fd_t fd);
 
+  //!
+  //! io service error callback
+  //! called by the io service whenever an error or a hangup is reported while no read or write operation is pending
+  //! disconnects the client right away, so that a dead connection does not hold its fd until the next async operation
+  //! if the peer closed its side with data still buffered, the client stays connected (and stops watching for errors): reads return that data, then fail on EOF
+  //!
+  //! \param fd file description of the socket for which the error is reported
+  //!
+  void on_error(fd_t fd);
+
+  //!
+  //! user code to be executed once the deadline of a request expired: callback of the request, then the disconnection handler if the client has been disconnected
+  //! executed once the timer no longer counts as calling into the client (see timers_state), so that the client can be destroyed from it
+  //!
+  struct timeout_notification {
+    //!
+    //! callback of the expired read request, if any
+    //!
+    async_read_callback_t read_callback;
+    //!
+    //! callback of the expired write request, if any
+    //!
+    async_write_callback_t write_callback;
+    //!
+    //! disconnection handler, if the request disconnected the client
+    //!
+    disconnection_handler_t disconnection_handler;
+
+    //!
+    //! execute the callbacks
+    //!
+    void operator()(void);
+  };
+
+  //!
+  //! called by the io_service timers whenever the deadline of a read request expires
+  //!
+  //! \param id id of the read request
+  //! \return user code to be executed (see timeout_notification)
+  //!
+  timeout_notification on_read_timeout(std::uint64_t id);
+
+  //!
+  //! called by the io_service timers whenever the deadline of a write request expires
+  //!
+  //! \param id id of the write request
+  //! \return user code to be executed (see timeout_notification)
+  //!
+  timeout_notification on_write_timeout(std::uint64_t id);
+
+  //!
+  //! schedule the deadline timer of a read or write request
+  //!
+  //! \param timeout_msecs deadline of the request
+  //! \param on_timeout on_read_timeout or on_write_timeout
+  //! \param id id of the request
+  //! \return id of the timer
+  //!
+  io_service::timer_id_t schedule_request_timeout(std::uint32_t timeout_msecs, timeout_notification (tcp_client::*on_timeout)(std::uint64_t), std::uint64_t id);
+
 private:
   //!
   //! Clear pending read requests (basically empty the queue of read requests)
@@ -286,6 +444,40 @@ private:
   //!
   async_write_callback_t process_write(write_result& result);
 
+private:
+  //!
+  //! struct pending_read_request
+  //! read request queued until the socket is readable
+  //!  * id: identifies the request for its deadline timer
+  //!  * timer_id: deadline timer (0 if the request has no deadline)
+  //!
+  struct pending_read_request {
+    read_request request;
+    std::uint64_t id;
+    io_service::timer_id_t timer_id;
+  };
+
+  //!
+  //! struct pending_write_request
+  //! write request queued until the socket is writable
+  //!  * id: identifies the request for its deadline timer, and its send (completion-based operations)
+  //!  * timer_id: deadline timer (0 if the request has no deadline)
+  //!
+  struct pending_write_request {
+    write_request request;
+    std::uint64_t id;
+    io_service::timer_id_t timer_id;
+  };
+
+private:
+  //!
+  //! submit the send of the given write request (completion-based operations only)
+  //! must be called with m_write_requests_mtx held, while no send is in progress
+  //!
+  //! \param pending write request to be sent (its buffer is handed over to the io_service)
+  //!
+  void submit_send(pending_write_request& pending);
+
 private:
   //!
   //! store io_service
@@ -293,6 +485,11 @@ private:
   //!
   std::shared_ptr<io_service> m_io_service;
 
+  //!
+  //! io_service_group the socket is assigned from on connection (may be null)
+  //!
+  std::shared_ptr<io_service_group> m_io_service_group;
+
   //!
   //! client socket
   //!
@@ -303,14 +500,67 @@ private:
   //!
   std::atomic<bool> m_is_connected = ATOMIC_VAR_INIT(false);
 
+  //!
+  //! whether reads and writes are submitted as completion-based operations (see io_service::supports_completions)
+  //!
+  bool m_use_completions = false;
+
+  //!
+  //! whether a send is in progress (completion-based operations only), protected by m_write_requests_mtx
+  //! the send of a request that timed out may still be in progress: the next request is only sent once it completed
+  //!
+  bool m_is_send_in_progress = false;
+
   //!
   //! read requests
   //!
-  std::queue<read_request> m_read_requests;
+  std::deque<pending_read_request> m_read_requests;
   //!
   //! write requests
   //!
-  std::queue<write_request> m_write_requests;
+  std::deque<pending_write_request> m_write_requests;
+
+  //!
+  //! id of the next read or write request
+  //!
+  std::atomic<std::uint64_t> m_next_request_id = ATOMIC_VAR_INIT(1);
+
+  //!
+  //! state shared between the client and its deadline timers
+  //! timers only call into the client while it is alive, and the destructor waits (without spinning) for the calls in progress
+  //! user code is not part of these calls, so that destroying the client from its own timeout callbacks does not wait on itself
+  //!
+  struct timers_state {
+    //! ctor
+    explicit timers_state(tcp_client* client)
+    : client(client)
+    , nb_executing(0) {}
+
+    //!
+    //! client the timers refer to, reset on destruction
+    //!
+    tcp_client* client;
+
+    //!
+    //! number of timer callbacks currently calling into the client
+    //!
+    std::size_t nb_executing;
+
+    //!
+    //! thread safety
+    //!
+    std::mutex mtx;
+
+    //!
+    //! notified whenever nb_executing drops to 0
+    //!
+    std::condition_variable executing_condvar;
+  };
+
+  //!
+  //! deadline timers refer to the client through this state
+  //!
+  std::shared_ptr<timers_state> m_timers_state = std::make_shared<timers_state>(this);
 
   //!
   //! read requests thread safety
@@ -321,6 +571,16 @@ private:
   //!
   std::mutex m_write_requests_mtx;
 
+  //!
+  //! strand executing the callbacks of the client (may be null)
+  //!
+  std::shared_ptr<utils::strand> m_strand;
+
+  //!
+  //! priority of the client
+  //!
+  io_service::priority m_priority = io_service::priority::normal;
+
   //!
   //! disconnection handler
   //!
@@ -30,6 +30,7 @@
 #include <string>
 
 #include <tacopie/network/io_service.hpp>
+#include <tacopie/network/io_service_group.hpp>
 #include <tacopie/network/tcp_client.hpp>
 #include <tacopie/network/tcp_socket.hpp>
 #include <tacopie/utils/typedefs.hpp>
@@ -49,6 +50,14 @@ public:
   //! dtor
   ~tcp_server(void);
 
+  //!
+  //! custom ctor
+  //! the server socket and each accepted client are assigned to one of the io_services of the group
+  //!
+  //! \param group io_service_group used to assign the sockets
+  //!
+  explicit tcp_server(const std::shared_ptr<io_service_group>& group);
+
   //! copy ctor
   tcp_server(const tcp_server&) = delete;
   //! assignment operator
@@ -146,6 +155,11 @@ private:
   //!
   std::shared_ptr<io_service> m_io_service;
 
+  //!
+  //! io_service_group the sockets are assigned from (may be null)
+  //!
+  std::shared_ptr<io_service_group> m_io_service_group;
+
   //1
   //! server socket
   //!
@@ -156,6 +170,11 @@ private:
   //!
   std::atomic<bool> m_is_running = ATOMIC_VAR_INIT(false);
 
+  //!
+  //! whether connections are accepted through completion-based operations (see io_service::supports_completions)
+  //!
+  bool m_use_completions = false;
+
   //!
   //! clients
   //!
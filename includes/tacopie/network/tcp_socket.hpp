@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include <tacopie/network/poller.hpp>
 #include <tacopie/utils/typedefs.hpp>
 
 namespace tacopie {
@@ -98,6 +99,15 @@ public:
   //!
   std::vector<char> recv(std::size_t size_to_read);
 
+  //!
+  //! Check, without consuming anything, whether the peer closed the connection and all of its data has been read (that is, recv would report EOF).
+  //! Does not block where MSG_DONTWAIT is supported (unix), and should otherwise only be called once the poller reported a hangup.
+  //! Throws if the connection failed.
+  //!
+  //! \return Returns whether the connection has been closed by the peer with no data left to read
+  //!
+  bool is_remotely_closed(void);
+
   //!
   //! Send data synchronously to the underlying socket.
   //! The socket must be of type client to process this operation. If the type of the socket is unknown, the socket type will be set to client.
@@ -143,6 +153,15 @@ public:
   //!
   tcp_socket accept(void);
 
+  //!
+  //! Build the tcp_socket of a connection accepted through a completion-based operation (see io_service::submit_accept).
+  //! The socket must be of type server to process this operation. If the type of the socket is unknown, the socket type will be set to server.
+  //!
+  //! \param completion Result of the accept operation.
+  //! \return Return the tcp_socket associated to the newly accepted connection.
+  //!
+  tcp_socket accept(const poller_iface::completion& completion);
+
   //!
   //! Close the underlying socket.
   //!
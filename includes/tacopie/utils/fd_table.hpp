@@ -0,0 +1,233 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#ifdef _WIN32
+#include <unordered_map>
+#else
+#include <vector>
+#endif /* _WIN32 */
+
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/typedefs.hpp>
+
+#ifndef __TACOPIE_FD_TABLE_PAGE_SIZE
+#define __TACOPIE_FD_TABLE_PAGE_SIZE 256
+#endif /* __TACOPIE_FD_TABLE_PAGE_SIZE */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! table of entries indexed by fd
+//! entries are stored contiguously in pages of __TACOPIE_FD_TABLE_PAGE_SIZE entries that are never released:
+//!  * lookups do not require any hashing (on unix, fds are small and dense integers)
+//!  * inserting an entry does not require any allocation (except when a new page is needed)
+//!  * the address of an entry never changes
+//! each entry is associated to a generation, incremented whenever a new entry is inserted for a fd, so that fd reuse can be detected
+//! on windows, SOCKET values are not guaranteed to be small nor dense: pages are then stored in a hash table
+//!
+//! not thread safe
+//!
+template <typename T>
+class fd_table {
+public:
+  //! ctor
+  fd_table(void) = default;
+  //! dtor
+  ~fd_table(void) = default;
+
+  //! copy ctor
+  fd_table(const fd_table&) = delete;
+  //! assignment operator
+  fd_table& operator=(const fd_table&) = delete;
+
+public:
+  //!
+  //! \param fd fd to look for
+  //! \return entry associated to the fd, nullptr if none
+  //!
+  T*
+  find(fd_t fd) {
+    slot* s = get_slot(fd, false);
+
+    return (s && s->in_use) ? &s->value : nullptr;
+  }
+
+  //!
+  //! \param fd fd to look for
+  //! \param generation generation of the expected entry (as returned by get_generation)
+  //! \return entry associated to the fd, nullptr if none or if the fd has been reused since (that is, generation differs)
+  //!
+  T*
+  find(fd_t fd, std::uint64_t generation) {
+    slot* s = get_slot(fd, false);
+
+    return (s && s->in_use && s->generation == generation) ? &s->value : nullptr;
+  }
+
+  //!
+  //! \param fd fd to look for
+  //! \return entry associated to the fd, default constructed and inserted if none
+  //! throws if the fd is invalid (negative, or __TACOPIE_INVALID_FD on windows)
+  //!
+  T&
+  operator[](fd_t fd) {
+    slot* s = get_slot(fd, true);
+
+    if (!s->in_use) {
+      s->in_use = true;
+      ++s->generation;
+      ++m_size;
+    }
+
+    return s->value;
+  }
+
+  //!
+  //! remove (and reset) the entry associated to the fd, if any
+  //!
+  //! \param fd fd of the entry to be removed
+  //!
+  void
+  erase(fd_t fd) {
+    slot* s = get_slot(fd, false);
+
+    if (!s || !s->in_use) { return; }
+
+    //! reset the entry in place (T is not required to be assignable)
+    s->value.~T();
+    new (&s->value) T();
+    s->in_use = false;
+    --m_size;
+  }
+
+  //!
+  //! \param fd fd of the entry
+  //! \return generation of the entry associated to the fd (or of the last one if the entry has been removed), 0 if none ever existed
+  //!
+  std::uint64_t
+  get_generation(fd_t fd) {
+    slot* s = get_slot(fd, false);
+
+    return s ? s->generation : 0;
+  }
+
+  //!
+  //! \return number of entries
+  //!
+  std::size_t
+  size(void) const {
+    return m_size;
+  }
+
+private:
+  //!
+  //! entry storage
+  //!
+  struct slot {
+    T value;
+    std::uint64_t generation = 0;
+    bool in_use              = false;
+  };
+
+  //!
+  //! page of contiguous slots
+  //!
+  struct page {
+    slot slots[__TACOPIE_FD_TABLE_PAGE_SIZE];
+  };
+
+  //!
+  //! \param fd fd of the slot
+  //! \param create whether the page containing the slot should be allocated if it does not exist yet
+  //! \return slot associated to the fd, nullptr if its page does not exist and create is false
+  //! invalid fds have no slot (converted to an index, a negative fd would require a huge table): nullptr is returned, or an error is thrown if create is true
+  //!
+  slot*
+  get_slot(fd_t fd, bool create) {
+#ifdef _WIN32
+    if (fd == __TACOPIE_INVALID_FD) {
+#else
+    if (fd < 0) {
+#endif /* _WIN32 */
+      if (create) { __TACOPIE_THROW(error, "invalid fd"); }
+
+      return nullptr;
+    }
+
+    std::size_t index      = static_cast<std::size_t>(fd);
+    std::size_t page_index = index / __TACOPIE_FD_TABLE_PAGE_SIZE;
+
+#ifdef _WIN32
+    auto it = m_pages.find(page_index);
+    if (it == m_pages.end()) {
+      if (!create) { return nullptr; }
+
+      it = m_pages.emplace(page_index, std::unique_ptr<page>(new page)).first;
+    }
+
+    return &it->second->slots[index % __TACOPIE_FD_TABLE_PAGE_SIZE];
+#else
+    if (page_index >= m_pages.size()) {
+      if (!create) { return nullptr; }
+
+      m_pages.resize(page_index + 1);
+    }
+
+    if (!m_pages[page_index]) {
+      if (!create) { return nullptr; }
+
+      m_pages[page_index].reset(new page);
+    }
+
+    return &m_pages[page_index]->slots[index % __TACOPIE_FD_TABLE_PAGE_SIZE];
+#endif /* _WIN32 */
+  }
+
+private:
+  //!
+  //! pages of slots, indexed by fd / __TACOPIE_FD_TABLE_PAGE_SIZE
+  //!
+#ifdef _WIN32
+  std::unordered_map<std::size_t, std::unique_ptr<page>> m_pages;
+#else
+  std::vector<std::unique_ptr<page>> m_pages;
+#endif /* _WIN32 */
+
+  //!
+  //! number of entries
+  //!
+  std::size_t m_size = 0;
+};
+
+} // namespace utils
+
+} // namespace tacopie
@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <tacopie/utils/typedefs.hpp>
+
+#ifndef __TACOPIE_FLIGHT_RECORDER_SIZE
+#define __TACOPIE_FLIGHT_RECORDER_SIZE 4096
+#endif /* __TACOPIE_FLIGHT_RECORDER_SIZE */
+
+#ifndef __TACOPIE_FLIGHT_RECORDER_MAX_THREADS
+#define __TACOPIE_FLIGHT_RECORDER_MAX_THREADS 64
+#endif /* __TACOPIE_FLIGHT_RECORDER_MAX_THREADS */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! always-on recorder of the io_service events, to find out what the reactor did right before a latency spike
+//! each thread records into its own fixed-size ring buffer (__TACOPIE_FLIGHT_RECORDER_SIZE entries, a power of 2), so recording neither locks nor allocates (except for the first event of a thread)
+//! at most __TACOPIE_FLIGHT_RECORDER_MAX_THREADS threads record at the same time, the buffers of exited threads are reused
+//! the buffers can be dumped at any time (including from a signal handler) and decoded by the tacopie_flight_recorder_decoder tool
+//!
+namespace flight_recorder {
+
+//!
+//! recorded events
+//!
+enum class event_type : std::uint16_t {
+  //! socket tracked
+  track = 1,
+  //! socket untracked
+  untrack = 2,
+  //! event reported by the poller (arg: reported poller_iface::event_type)
+  ready = 3,
+  //! callback handed over to the poll thread or to the callback workers (arg: poller_iface::event_type of the callback)
+  dispatch = 4,
+  //! callback execution started (arg: poller_iface::event_type of the callback)
+  callback_start = 5,
+  //! callback execution completed (arg: poller_iface::event_type of the callback)
+  callback_end = 6,
+  //! wake up of the poll thread requested through the notifier
+  wake_up = 7,
+  //! poll thread woken up by the notifier
+  notifier_wake = 8
+};
+
+//!
+//! recorded entry, as found in dumps
+//!  * timestamp: TSC on x86 and aarch64, steady clock nanoseconds otherwise (see file_header::ticks_per_second)
+//!  * fd: fd the event relates to (truncated to 32 bits, -1 if none)
+//!  * type: event_type
+//!  * arg: event specific argument
+//!
+struct entry {
+  std::uint64_t timestamp;
+  std::int32_t fd;
+  std::uint16_t type;
+  std::uint16_t arg;
+};
+
+//!
+//! header of a dump, followed by file_header::nb_threads thread sections
+//! all the fields are stored in the byte order of the recording host
+//!  * magic: "TACOFR1" (null terminated)
+//!  * ticks_per_second: timestamp frequency, 0 if unknown
+//!
+struct file_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t nb_threads;
+  std::uint64_t ticks_per_second;
+  std::uint64_t dumped_at;
+};
+
+//!
+//! header of a thread section, followed by thread_header::nb_entries entries (oldest first)
+//!  * thread_id: system thread id on linux, hash of the std::thread::id otherwise
+//!
+struct thread_header {
+  std::uint64_t thread_id;
+  std::uint32_t nb_entries;
+  std::uint32_t reserved;
+};
+
+//!
+//! current dump format version
+//!
+static const std::uint32_t format_version = 1;
+
+//!
+//! record an event in the buffer of the calling thread
+//! does nothing if recording is disabled, or if all the buffers are used by other threads
+//!
+//! \param type event type
+//! \param fd fd the event relates to
+//! \param arg event specific argument
+//!
+void record(event_type type, fd_t fd, std::uint16_t arg = 0);
+
+//!
+//! enable or disable recording at runtime (enabled by default)
+//!
+//! \param enabled whether events should be recorded
+//!
+void set_enabled(bool enabled);
+
+//!
+//! \return whether events are recorded
+//!
+bool is_enabled(void);
+
+//!
+//! write the content of all the buffers to a file
+//! entries recorded while dumping may be torn or missing
+//!
+//! \param path path of the file to be written (truncated if it exists)
+//!
+void dump(const std::string& path);
+
+//!
+//! dump the buffers whenever the process receives the given signal
+//! the dump only uses async-signal-safe calls and overwrites the file on each signal
+//!
+//! \param signal_number signal triggering the dump (typically SIGUSR1)
+//! \param path path of the file to be written
+//!
+void dump_on_signal(int signal_number, const std::string& path);
+
+//!
+//! \param type event type
+//! \return name of the event type ("unknown" for unknown types)
+//!
+const char* get_event_name(std::uint16_t type);
+
+} // namespace flight_recorder
+
+//! convenience macro, compiled out if __TACOPIE_FLIGHT_RECORDER_DISABLED is defined
+#ifndef __TACOPIE_FLIGHT_RECORDER_DISABLED
+#define __TACOPIE_RECORD(type, fd, arg) tacopie::utils::flight_recorder::record(tacopie::utils::flight_recorder::event_type::type, fd, arg)
+#else
+#define __TACOPIE_RECORD(type, fd, arg)
+#endif /* __TACOPIE_FLIGHT_RECORDER_DISABLED */
+
+} // namespace utils
+
+} // namespace tacopie
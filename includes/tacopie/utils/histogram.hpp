@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifndef __TACOPIE_HISTOGRAM_PRECISION_BITS
+#define __TACOPIE_HISTOGRAM_PRECISION_BITS 4
+#endif /* __TACOPIE_HISTOGRAM_PRECISION_BITS */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! lock-free log-linear histogram (HDR-style)
+//! each power of two range is split into 2^__TACOPIE_HISTOGRAM_PRECISION_BITS linear sub-buckets, so that recorded values are kept with a bounded relative error (about 6% by default) over the whole uint64 range
+//! values below 2^__TACOPIE_HISTOGRAM_PRECISION_BITS are kept exactly
+//! record can be called concurrently from any thread, readers get a view that may be slightly inconsistent while values are being recorded
+//!
+class histogram {
+public:
+  //! ctor
+  histogram(void);
+  //! dtor
+  ~histogram(void) = default;
+
+  //! copy ctor
+  histogram(const histogram&) = delete;
+  //! assignment operator
+  histogram& operator=(const histogram&) = delete;
+
+public:
+  //!
+  //! record a value
+  //!
+  //! \param value value to be recorded
+  //!
+  void record(std::uint64_t value);
+
+  //!
+  //! clear all the recorded values
+  //!
+  void reset(void);
+
+public:
+  //!
+  //! \return number of recorded values
+  //!
+  std::uint64_t get_count(void) const;
+
+  //!
+  //! \return highest recorded value (0 if none)
+  //!
+  std::uint64_t get_max(void) const;
+
+  //!
+  //! \return mean of the recorded values (0 if none)
+  //!
+  double get_mean(void) const;
+
+  //!
+  //! \param percentile percentile, between 0 and 100
+  //! \return value below which the given percentage of the recorded values falls (highest value of the matching bucket, 0 if none)
+  //!
+  std::uint64_t get_value_at_percentile(double percentile) const;
+
+  //!
+  //! \return non-empty buckets, as pairs of <highest value of the bucket, number of values recorded in the bucket>, in ascending order
+  //!
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> get_buckets(void) const;
+
+private:
+  //!
+  //! \param value recorded value
+  //! \return index of the bucket the value belongs to
+  //!
+  static std::size_t get_bucket_index(std::uint64_t value);
+
+  //!
+  //! \param index index of a bucket
+  //! \return highest value belonging to the bucket
+  //!
+  static std::uint64_t get_bucket_upper_bound(std::size_t index);
+
+private:
+  //!
+  //! number of sub-buckets per power of two range
+  //!
+  static const std::size_t nb_sub_buckets = static_cast<std::size_t>(1) << __TACOPIE_HISTOGRAM_PRECISION_BITS;
+
+  //!
+  //! number of buckets: exact values below nb_sub_buckets, then one range per remaining power of two
+  //!
+  static const std::size_t nb_buckets = (64 - __TACOPIE_HISTOGRAM_PRECISION_BITS + 1) * nb_sub_buckets;
+
+  //!
+  //! buckets
+  //!
+  std::atomic<std::uint64_t> m_buckets[nb_buckets];
+
+  //!
+  //! number, sum and maximum of the recorded values
+  //!
+  std::atomic<std::uint64_t> m_count;
+  std::atomic<std::uint64_t> m_sum;
+  std::atomic<std::uint64_t> m_max;
+};
+
+} // namespace utils
+
+} // namespace tacopie
@@ -0,0 +1,126 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! unbounded lock-free multi-producer single-consumer queue (non-intrusive version of Dmitry Vyukov's MPSC queue)
+//! push can be called concurrently from any thread, pop must always be called from the same (consumer) thread
+//! push is wait-free (one atomic exchange), pop never blocks but may transiently report an empty queue while a push is in progress
+//!
+template <typename T>
+class mpsc_queue {
+public:
+  //! ctor
+  mpsc_queue(void)
+  : m_head(new node)
+  , m_tail(m_head.load()) {}
+
+  //! dtor
+  ~mpsc_queue(void) {
+    T value;
+    while (pop(value)) {}
+
+    delete m_tail;
+  }
+
+  //! copy ctor
+  mpsc_queue(const mpsc_queue&) = delete;
+  //! assignment operator
+  mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+public:
+  //!
+  //! push a value (producers)
+  //!
+  //! \param value value to be pushed
+  //!
+  void
+  push(T value) {
+    node* new_node = new node(std::move(value));
+    node* previous = m_head.exchange(new_node, std::memory_order_acq_rel);
+
+    previous->next.store(new_node, std::memory_order_release);
+  }
+
+  //!
+  //! pop a value (consumer)
+  //!
+  //! \param value set to the popped value
+  //! \return whether a value has been popped
+  //!
+  bool
+  pop(T& value) {
+    node* tail = m_tail;
+    node* next = tail->next.load(std::memory_order_acquire);
+
+    if (!next) { return false; }
+
+    //! next becomes the new stub node
+    value  = std::move(next->value);
+    m_tail = next;
+    delete tail;
+
+    return true;
+  }
+
+private:
+  //!
+  //! struct node
+  //!
+  struct node {
+    //! ctor
+    node(void)
+    : next(nullptr) {}
+
+    //! ctor
+    explicit node(T&& value)
+    : next(nullptr)
+    , value(std::move(value)) {}
+
+    std::atomic<node*> next;
+    T value;
+  };
+
+private:
+  //!
+  //! last pushed node, where producers append
+  //!
+  std::atomic<node*> m_head;
+
+  //!
+  //! stub node preceding the next value to be popped, only accessed by the consumer
+  //!
+  node* m_tail;
+};
+
+} // namespace utils
+
+} // namespace tacopie
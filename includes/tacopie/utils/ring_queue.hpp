@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! FIFO queue stored in a growable circular buffer (not thread safe)
+//! unlike std::deque, it keeps its capacity once grown: pushing and popping in steady state never allocates
+//! T must be default constructible and move assignable, popped slots are reset to a default constructed value
+//!
+template <typename T>
+class ring_queue {
+public:
+  //! ctor
+  ring_queue(void)
+  : m_head(0)
+  , m_size(0) {}
+
+  //! dtor
+  ~ring_queue(void) = default;
+
+  //! copy ctor
+  ring_queue(const ring_queue&) = delete;
+  //! assignment operator
+  ring_queue& operator=(const ring_queue&) = delete;
+
+public:
+  //!
+  //! push a value at the back of the queue, doubling the capacity if the queue is full
+  //!
+  //! \param value value to be pushed
+  //!
+  void
+  push(T value) {
+    if (m_size == m_buffer.size()) { grow(); }
+
+    m_buffer[(m_head + m_size) & (m_buffer.size() - 1)] = std::move(value);
+    ++m_size;
+  }
+
+  //!
+  //! \return value at the front of the queue (the queue must not be empty)
+  //!
+  T&
+  front(void) {
+    return m_buffer[m_head];
+  }
+
+  //!
+  //! remove the value at the front of the queue (the queue must not be empty)
+  //!
+  void
+  pop(void) {
+    m_buffer[m_head] = T();
+    m_head           = (m_head + 1) & (m_buffer.size() - 1);
+    --m_size;
+  }
+
+  //!
+  //! \return whether the queue is empty
+  //!
+  bool
+  empty(void) const {
+    return m_size == 0;
+  }
+
+  //!
+  //! \return number of values in the queue
+  //!
+  std::size_t
+  size(void) const {
+    return m_size;
+  }
+
+private:
+  //!
+  //! double the capacity (always a power of 2), moving the values to the beginning of the new buffer
+  //!
+  void
+  grow(void) {
+    std::vector<T> buffer(m_buffer.empty() ? 16 : m_buffer.size() * 2);
+
+    for (std::size_t i = 0; i < m_size; ++i) { buffer[i] = std::move(m_buffer[(m_head + i) & (m_buffer.size() - 1)]); }
+
+    m_buffer.swap(buffer);
+    m_head = 0;
+  }
+
+private:
+  //!
+  //! circular buffer, its size is 0 or a power of 2
+  //!
+  std::vector<T> m_buffer;
+
+  //!
+  //! index of the front value
+  //!
+  std::size_t m_head;
+
+  //!
+  //! number of values in the queue
+  //!
+  std::size_t m_size;
+};
+
+} // namespace utils
+
+} // namespace tacopie
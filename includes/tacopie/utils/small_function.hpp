@@ -0,0 +1,288 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef __TACOPIE_SMALL_FUNCTION_SIZE
+#define __TACOPIE_SMALL_FUNCTION_SIZE 48
+#endif /* __TACOPIE_SMALL_FUNCTION_SIZE */
+
+namespace tacopie {
+
+namespace utils {
+
+template <typename Signature, std::size_t Size = __TACOPIE_SMALL_FUNCTION_SIZE>
+class small_function;
+
+//!
+//! move-only replacement of std::function, storing the callable inline (no heap allocation) whenever it fits in Size bytes
+//! callables that are larger, over-aligned or that may throw when moved are stored on the heap instead
+//! the size of a small_function is Size plus one pointer
+//!
+template <typename R, typename... Args, std::size_t Size>
+class small_function<R(Args...), Size> {
+public:
+  //! ctor
+  small_function(void)
+  : m_ops(nullptr) {}
+
+  //! ctor
+  small_function(std::nullptr_t)
+  : m_ops(nullptr) {}
+
+  //!
+  //! ctor
+  //! null function pointers and empty std::function result in an empty small_function
+  //!
+  //! \param callable callable to be stored
+  //!
+  template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, small_function>::value>::type>
+  small_function(F&& callable)
+  : m_ops(nullptr) {
+    typedef typename std::decay<F>::type callable_t;
+
+    if (is_empty(callable)) { return; }
+
+    store(std::forward<F>(callable), is_stored_inline<callable_t>());
+  }
+
+  //! dtor
+  ~small_function(void) {
+    reset();
+  }
+
+  //! move ctor
+  small_function(small_function&& other) noexcept
+  : m_ops(other.m_ops) {
+    if (m_ops) {
+      m_ops->move(&m_storage, &other.m_storage);
+      other.m_ops = nullptr;
+    }
+  }
+
+  //! move assignment operator
+  small_function&
+  operator=(small_function&& other) noexcept {
+    if (this != &other) {
+      reset();
+
+      m_ops = other.m_ops;
+      if (m_ops) {
+        m_ops->move(&m_storage, &other.m_storage);
+        other.m_ops = nullptr;
+      }
+    }
+
+    return *this;
+  }
+
+  //! reset assignment operator
+  small_function&
+  operator=(std::nullptr_t) {
+    reset();
+
+    return *this;
+  }
+
+  //! copy ctor
+  small_function(const small_function&) = delete;
+  //! assignment operator
+  small_function& operator=(const small_function&) = delete;
+
+public:
+  //!
+  //! call the stored callable
+  //! throws std::bad_function_call if empty
+  //!
+  R
+  operator()(Args... args) const {
+    if (!m_ops) { throw std::bad_function_call(); }
+
+    return m_ops->invoke(&m_storage, std::forward<Args>(args)...);
+  }
+
+  //!
+  //! \return whether a callable is stored
+  //!
+  explicit operator bool(void) const {
+    return m_ops != nullptr;
+  }
+
+  //!
+  //! \return whether the stored callable (if any) lives in the inline storage
+  //!
+  bool
+  is_inline(void) const {
+    return m_ops && m_ops->is_inline;
+  }
+
+private:
+  //!
+  //! operations on the stored callable, one static instance per callable type and storage strategy
+  //!
+  struct operations {
+    R (*invoke)(void* storage, Args&&... args);
+    void (*move)(void* dst, void* src);
+    void (*destroy)(void* storage);
+    bool is_inline;
+  };
+
+  //!
+  //! callables that fit in the inline storage and can be moved without throwing (so that small_function moves are noexcept)
+  //!
+  template <typename F>
+  struct is_stored_inline : std::integral_constant<bool, sizeof(F) <= Size && std::alignment_of<F>::value <= std::alignment_of<std::max_align_t>::value && std::is_nothrow_move_constructible<F>::value> {};
+
+  template <typename F>
+  struct inline_ops {
+    static R
+    invoke(void* storage, Args&&... args) {
+      return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+    }
+
+    static void
+    move(void* dst, void* src) {
+      new (dst) F(std::move(*static_cast<F*>(src)));
+      static_cast<F*>(src)->~F();
+    }
+
+    static void
+    destroy(void* storage) {
+      static_cast<F*>(storage)->~F();
+    }
+
+    static const operations ops;
+  };
+
+  template <typename F>
+  struct heap_ops {
+    static R
+    invoke(void* storage, Args&&... args) {
+      return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+    }
+
+    static void
+    move(void* dst, void* src) {
+      *static_cast<F**>(dst) = *static_cast<F**>(src);
+    }
+
+    static void
+    destroy(void* storage) {
+      delete *static_cast<F**>(storage);
+    }
+
+    static const operations ops;
+  };
+
+private:
+  //!
+  //! store the callable inline
+  //!
+  template <typename F>
+  void
+  store(F&& callable, std::true_type) {
+    typedef typename std::decay<F>::type callable_t;
+
+    new (&m_storage) callable_t(std::forward<F>(callable));
+    m_ops = &inline_ops<callable_t>::ops;
+  }
+
+  //!
+  //! store the callable on the heap
+  //!
+  template <typename F>
+  void
+  store(F&& callable, std::false_type) {
+    typedef typename std::decay<F>::type callable_t;
+
+    new (&m_storage) callable_t*(new callable_t(std::forward<F>(callable)));
+    m_ops = &heap_ops<callable_t>::ops;
+  }
+
+  //!
+  //! destroy the stored callable, if any
+  //!
+  void
+  reset(void) {
+    if (m_ops) {
+      m_ops->destroy(&m_storage);
+      m_ops = nullptr;
+    }
+  }
+
+  //!
+  //! null function pointers, member pointers and std::function
+  //!
+  template <typename F>
+  static bool
+  is_empty(F* callable) {
+    return callable == nullptr;
+  }
+
+  template <typename F, typename C>
+  static bool
+  is_empty(F C::*callable) {
+    return callable == nullptr;
+  }
+
+  template <typename Signature>
+  static bool
+  is_empty(const std::function<Signature>& callable) {
+    return !callable;
+  }
+
+  template <typename F>
+  static bool
+  is_empty(const F&) {
+    return false;
+  }
+
+private:
+  //!
+  //! inline storage of the callable (or pointer to the callable, if stored on the heap)
+  //!
+  mutable typename std::aligned_storage<(Size < sizeof(void*) ? sizeof(void*) : Size), std::alignment_of<std::max_align_t>::value>::type m_storage;
+
+  //!
+  //! operations on the stored callable, null if empty
+  //!
+  const operations* m_ops;
+};
+
+template <typename R, typename... Args, std::size_t Size>
+template <typename F>
+const typename small_function<R(Args...), Size>::operations small_function<R(Args...), Size>::inline_ops<F>::ops = {&inline_ops<F>::invoke, &inline_ops<F>::move, &inline_ops<F>::destroy, true};
+
+template <typename R, typename... Args, std::size_t Size>
+template <typename F>
+const typename small_function<R(Args...), Size>::operations small_function<R(Args...), Size>::heap_ops<F>::ops = {&heap_ops<F>::invoke, &heap_ops<F>::move, &heap_ops<F>::destroy, false};
+
+} // namespace utils
+
+} // namespace tacopie
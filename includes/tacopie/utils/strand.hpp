@@ -0,0 +1,130 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <tacopie/utils/ring_queue.hpp>
+#include <tacopie/utils/thread_pool.hpp>
+
+#ifndef __TACOPIE_STRAND_MAX_BATCH
+#define __TACOPIE_STRAND_MAX_BATCH 64
+#endif /* __TACOPIE_STRAND_MAX_BATCH */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! ordered and non-concurrent execution context on top of a thread_pool
+//! tasks posted to a strand are executed by the workers of the thread_pool (or by a custom executor), one at a time and in the order they have been posted
+//! a strand must be owned by a std::shared_ptr (it keeps itself alive while it has tasks to execute) and must not outlive its executor
+//!
+class strand : public std::enable_shared_from_this<strand> {
+public:
+  //! task typedef
+  typedef thread_pool::task_t task_t;
+
+  //! function handing the execution of a task over to another context
+  typedef std::function<void(task_t&&)> executor_t;
+
+public:
+  //!
+  //! ctor
+  //!
+  //! \param executor thread_pool executing the tasks of the strand
+  //!
+  explicit strand(thread_pool& executor);
+
+  //!
+  //! ctor
+  //!
+  //! \param executor executor in charge of the execution of the tasks of the strand
+  //!
+  explicit strand(const executor_t& executor);
+
+  //! dtor
+  ~strand(void) = default;
+
+  //! copy ctor
+  strand(const strand&) = delete;
+  //! assignment operator
+  strand& operator=(const strand&) = delete;
+
+public:
+  //!
+  //! add task to the strand
+  //! the task is executed once all the tasks previously posted to the strand have completed
+  //!
+  //! \param task task to be executed
+  //!
+  void post(task_t task);
+
+  //!
+  //! same as post
+  //!
+  //! \param task task to be executed
+  //! \return current instance
+  //!
+  strand& operator<<(task_t task);
+
+private:
+  //!
+  //! execute the pending tasks, up to __TACOPIE_STRAND_MAX_BATCH
+  //! called by a worker of the thread_pool, reschedules itself if tasks are left once the batch is completed
+  //!
+  void run(void);
+
+  //!
+  //! hand a call to run over to the executor
+  //!
+  void schedule(void);
+
+private:
+  //!
+  //! executor of the tasks
+  //!
+  executor_t m_executor;
+
+  //!
+  //! pending tasks
+  //!
+  ring_queue<task_t> m_tasks;
+
+  //!
+  //! whether a call to run is pending or in progress (at most one at a time)
+  //!
+  bool m_is_scheduled;
+
+  //!
+  //! tasks thread safety
+  //!
+  std::mutex m_tasks_mtx;
+};
+
+} // namespace utils
+
+} // namespace tacopie
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! restrict the given thread to run on the given cpus
+//! supported on linux and windows (on windows, only the first 64 cpus can be used), logs a warning and does nothing on other platforms
+//!
+//! \param thread thread to be pinned
+//! \param cpus indexes of the cpus the thread is allowed to run on
+//!
+void set_thread_affinity(std::thread& thread, const std::vector<std::size_t>& cpus);
+
+//!
+//! restrict the calling thread to run on the given cpus
+//! same platform support as set_thread_affinity
+//!
+//! \param cpus indexes of the cpus the thread is allowed to run on
+//!
+void set_current_thread_affinity(const std::vector<std::size_t>& cpus);
+
+//!
+//! name the given thread, as displayed by top, perf or debuggers
+//! supported on linux (names are truncated to 15 characters) and windows 10 or later, does nothing on other platforms
+//!
+//! \param thread thread to be named
+//! \param name name of the thread
+//!
+void set_thread_name(std::thread& thread, const std::string& name);
+
+//!
+//! name the calling thread
+//! supported on linux, macos and windows 10 or later, does nothing on other platforms
+//!
+//! \param name name of the thread
+//!
+void set_current_thread_name(const std::string& name);
+
+//!
+//! \return indexes of the cpus the calling thread is allowed to run on (inherited from the process, as restricted by taskset or cpusets)
+//!         supported on linux and windows (only the first 64 cpus), every cpu is assumed to be allowed on other platforms
+//!
+std::vector<std::size_t> get_allowed_cpus(void);
+
+//!
+//! \param cpu index of a cpu
+//! \return NUMA node the cpu belongs to, -1 if unknown (not supported on this platform)
+//!
+int get_numa_node(std::size_t cpu);
+
+//!
+//! \param node NUMA node
+//! \return indexes of the cpus belonging to the node, empty if unknown (not supported on this platform)
+//!
+std::vector<std::size_t> get_numa_node_cpus(int node);
+
+} // namespace utils
+
+} // namespace tacopie
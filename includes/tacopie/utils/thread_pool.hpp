@@ -27,16 +27,28 @@
 #include <functional>
 #include <list>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include <tacopie/utils/ring_queue.hpp>
+#include <tacopie/utils/small_function.hpp>
+
+#ifndef __TACOPIE_THREAD_POOL_TASK_SIZE
+#define __TACOPIE_THREAD_POOL_TASK_SIZE 128
+#endif /* __TACOPIE_THREAD_POOL_TASK_SIZE */
+
+#ifndef __TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE
+#define __TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE 8
+#endif /* __TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE */
+
 namespace tacopie {
 
 namespace utils {
 
 //!
 //! basic thread pool used to push async tasks from the io_service
+//! tasks are queued by priority: high priority tasks are executed first, while normal priority tasks still get a share of the workers (see set_high_priority_share)
 //!
 class thread_pool {
 public:
@@ -59,17 +71,29 @@ public:
 public:
   //!
   //! task typedef
-  ///! simply a callable taking no parameter
+  //! simply a callable taking no parameter, stored inline (without allocation) if it fits in __TACOPIE_THREAD_POOL_TASK_SIZE bytes
+  //! large enough to hold an io_service event callback along with its dispatch context
   //!
-  typedef std::function<void()> task_t;
+  typedef small_function<void(), __TACOPIE_THREAD_POOL_TASK_SIZE> task_t;
+
+  //!
+  //! priority of a task
+  //!
+  enum class priority {
+    //! executed ahead of the normal priority tasks
+    high,
+    //! default priority
+    normal
+  };
 
   //!
   //! add tasks to thread pool
-  //! task is enqueued and will be executed whenever all previously executed tasked have been executed (or are currently being executed)
+  //! task is enqueued and will be executed whenever all previously executed tasked of the same priority have been executed (or are currently being executed)
   //!
   //! \param task task to be executed by the threadpool
+  //! \param task_priority priority of the task
   //!
-  void add_task(const task_t& task);
+  void add_task(task_t task, priority task_priority = priority::normal);
 
   //!
   //! same as add_task
@@ -77,7 +101,7 @@ public:
   //! \param task task to be executed by the threadpool
   //! \return current instance
   //!
-  thread_pool& operator<<(const task_t& task);
+  thread_pool& operator<<(task_t task);
 
   //!
   //! stop the thread pool and wait for workers completion
@@ -91,6 +115,42 @@ public:
   //!
   bool is_running(void) const;
 
+  //!
+  //! \return number of tasks waiting for a worker (lock-free, may be slightly outdated)
+  //!
+  std::size_t get_nb_pending_tasks(void) const;
+
+  //!
+  //! \return number of threads allowed, as set by the ctor or set_nb_threads (running threads may differ while the change is applied)
+  //!
+  std::size_t get_nb_threads(void) const;
+
+  //!
+  //! set the maximum number of high priority tasks executed in a row while normal priority tasks are pending
+  //! by default, __TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE is used
+  //!
+  //! \param share number of high priority tasks executed for each normal priority task (0 for strict priority: normal priority tasks may then starve)
+  //!
+  void set_high_priority_share(std::size_t share);
+
+  //!
+  //! restrict the workers to run on the given cpus
+  //! worker i is restricted to cpus[i % cpus.size()], so that a single set can be shared by all workers, or each worker can be pinned to its own cpu
+  //! applied by each worker between two tasks, including the workers spawned later on
+  //!
+  //! \param cpus sets of cpus the workers are allowed to run on (empty to leave the affinity unchanged)
+  //!
+  void set_workers_affinity(const std::vector<std::vector<std::size_t>>& cpus);
+
+  //!
+  //! name the workers, as displayed by top, perf or debuggers
+  //! worker i is named <name>-<i>
+  //! applied by each worker between two tasks, including the workers spawned later on
+  //!
+  //! \param name prefix of the workers name
+  //!
+  void set_workers_name(const std::string& name);
+
 public:
   //!
   //! reset the number of threads working in the thread pool
@@ -110,22 +170,36 @@ private:
   //!
   //! worker main loop
   //!
-  void run(void);
+  //! \param index index of the worker, used for its affinity and name
+  //!
+  void run(std::size_t index);
 
   //!
   //! retrieve a new task
   //! fetch the first element in the queue, or wait if no task are available
+  //! if the workers configuration changed since the worker last applied it, the returned task applies the new configuration
   //!
+  //! \param index index of the worker
+  //! \param config_generation generation of the workers configuration last applied by the worker, updated when a new configuration is returned
   //! \return a pair <stopped, task>
   //!         pair.first indicated whether the thread has been marked for stop and should return immediately
   //!         pair.second contains the task to be executed
   //!
-  std::pair<bool, task_t> fetch_task_or_stop(void);
+  std::pair<bool, task_t> fetch_task_or_stop(std::size_t index, std::size_t& config_generation);
 
   //!
+  //! apply affinity and name to the calling worker
+  //!
+  //! \param cpus cpus the worker is allowed to run on (empty to leave the affinity unchanged)
+  //! \param name name of the worker (empty to leave the name unchanged)
+  //!
+  static void apply_worker_config(const std::vector<std::size_t>& cpus, const std::string& name);
+
+  //!
+  //! \param index index of the worker
   //! \return whether the thread should stop or not
   //!
-  bool should_stop(void) const;
+  bool should_stop(std::size_t index) const;
 
 private:
   //!
@@ -143,6 +217,12 @@ private:
   //!
   std::atomic<std::size_t> m_nb_running_threads = ATOMIC_VAR_INIT(0);
 
+  //!
+  //! indexes held by the running threads, released when a thread stops so that the next spawned threads reuse them
+  //! threads with an index beyond m_max_nb_threads stop, and new threads take the free indexes below it: indexes stay within [0, m_max_nb_threads)
+  //!
+  std::vector<bool> m_workers_indexes;
+
   //!
   //! whether the thread_pool should stop or not
   //!
@@ -151,7 +231,42 @@ private:
   //!
   //! tasks
   //!
-  std::queue<task_t> m_tasks;
+  ring_queue<task_t> m_tasks;
+
+  //!
+  //! high priority tasks
+  //!
+  ring_queue<task_t> m_high_priority_tasks;
+
+  //!
+  //! maximum number of high priority tasks executed in a row while normal priority tasks are pending
+  //!
+  std::atomic<std::size_t> m_high_priority_share = ATOMIC_VAR_INIT(__TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE);
+
+  //!
+  //! number of high priority tasks fetched in a row while normal priority tasks were pending
+  //!
+  std::size_t m_nb_consecutive_high_priority_tasks = 0;
+
+  //!
+  //! number of tasks in m_tasks and m_high_priority_tasks, readable without locking
+  //!
+  std::atomic<std::size_t> m_nb_pending_tasks = ATOMIC_VAR_INIT(0);
+
+  //!
+  //! sets of cpus the workers are allowed to run on
+  //!
+  std::vector<std::vector<std::size_t>> m_workers_cpus;
+
+  //!
+  //! prefix of the workers name
+  //!
+  std::string m_workers_name;
+
+  //!
+  //! incremented whenever the workers configuration changes, so that each worker can apply it
+  //!
+  std::size_t m_workers_config_generation = 0;
 
   //!
   //! tasks thread safety
@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#ifndef __TACOPIE_TIMER_WHEEL_NB_LEVELS
+#define __TACOPIE_TIMER_WHEEL_NB_LEVELS 4
+#endif /* __TACOPIE_TIMER_WHEEL_NB_LEVELS */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! hierarchical timing wheel with a resolution of 1 millisecond
+//! each level contains 64 slots, each slot covering 64 times the duration of a slot of the previous level
+//! scheduling and cancelling a timer are O(1), timers are moved down to the previous level (cascaded) when their slot is reached
+//! timers beyond the range of the wheel are kept in the last slot of the highest level and re-inserted when cascaded
+//!
+//! not thread safe
+//!
+class timer_wheel {
+public:
+  //! timer identifier, 0 is never used
+  typedef std::uint64_t timer_id_t;
+
+  //! callback to be executed on timer expiry
+  typedef std::function<void(void)> callback_t;
+
+  //! clock used by the wheel
+  typedef std::chrono::steady_clock clock_t;
+
+public:
+  //! ctor
+  timer_wheel(void);
+  //! dtor
+  ~timer_wheel(void) = default;
+
+  //! copy ctor
+  timer_wheel(const timer_wheel&) = delete;
+  //! assignment operator
+  timer_wheel& operator=(const timer_wheel&) = delete;
+
+public:
+  //!
+  //! schedule a timer
+  //!
+  //! \param delay_msecs delay after which the timer expires
+  //! \param callback callback to be returned by advance once the timer expired
+  //! \param now current time
+  //! \return id of the timer
+  //!
+  timer_id_t schedule_after(std::uint32_t delay_msecs, const callback_t& callback, const clock_t::time_point& now = clock_t::now());
+
+  //!
+  //! cancel a timer
+  //!
+  //! \param id id of the timer
+  //! \return true if the timer was pending, false if it already expired (or never existed)
+  //!
+  bool cancel(timer_id_t id);
+
+  //!
+  //! advance the wheel up to the current time
+  //!
+  //! \param expired vector to which the callbacks of the expired timers are appended, in expiry order
+  //! \param now current time
+  //!
+  void advance(std::vector<callback_t>& expired, const clock_t::time_point& now = clock_t::now());
+
+  //!
+  //! \param now current time
+  //! \return number of milliseconds before the wheel must be advanced (the next expiry or the next cascade), -1 if no timer is pending
+  //!
+  int get_next_expiry_msecs(const clock_t::time_point& now = clock_t::now()) const;
+
+  //!
+  //! \return number of pending timers
+  //!
+  std::size_t size(void) const;
+
+private:
+  //!
+  //! struct timer
+  //! pending timer, stored in the slot of its expiry
+  //!
+  struct timer {
+    timer_id_t id;
+    std::uint64_t expiry;
+    callback_t callback;
+  };
+
+  //!
+  //! struct location
+  //! slot in which a timer is currently stored
+  //!
+  struct location {
+    std::size_t level;
+    std::size_t slot;
+    std::list<timer>::iterator it;
+  };
+
+private:
+  //!
+  //! \param now time to be converted
+  //! \return number of ticks elapsed between the creation of the wheel and the given time
+  //!
+  std::uint64_t get_tick(const clock_t::time_point& now) const;
+
+  //!
+  //! store a timer in the slot matching its expiry
+  //!
+  //! \param from list from which the timer must be moved
+  //! \param it timer to be moved
+  //!
+  void insert(std::list<timer>& from, std::list<timer>::iterator it);
+
+  //!
+  //! move the timers of the current slot of the given level to the lower levels
+  //!
+  //! \param level level to be cascaded
+  //! \return index of the slot cascaded
+  //!
+  std::size_t cascade(std::size_t level);
+
+private:
+  //!
+  //! slots of each level
+  //!
+  std::list<timer> m_slots[__TACOPIE_TIMER_WHEEL_NB_LEVELS][64];
+
+  //!
+  //! number of timers in each level
+  //!
+  std::size_t m_level_sizes[__TACOPIE_TIMER_WHEEL_NB_LEVELS];
+
+  //!
+  //! location of each pending timer
+  //!
+  std::unordered_map<timer_id_t, location> m_timers;
+
+  //!
+  //! creation time of the wheel (tick 0)
+  //!
+  clock_t::time_point m_origin;
+
+  //!
+  //! last tick processed by advance
+  //!
+  std::uint64_t m_current_tick;
+
+  //!
+  //! id of the next timer to be scheduled
+  //!
+  timer_id_t m_next_id;
+};
+
+} // namespace utils
+
+} // namespace tacopie
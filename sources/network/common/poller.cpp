@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/network/epoll_poller.hpp>
+#include <tacopie/network/io_uring_poller.hpp>
+#include <tacopie/network/poll_poller.hpp>
+#include <tacopie/network/poller.hpp>
+#include <tacopie/network/select_poller.hpp>
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+
+namespace tacopie {
+
+//!
+//! completion-based operations are not supported by default
+//!
+
+bool
+poller_iface::supports_completions(void) const {
+  return false;
+}
+
+void
+poller_iface::submit_recv(fd_t, std::size_t) {
+  __TACOPIE_THROW(error, "poller does not support completion-based operations");
+}
+
+void
+poller_iface::submit_send(fd_t, std::vector<char>, std::uint64_t) {
+  __TACOPIE_THROW(error, "poller does not support completion-based operations");
+}
+
+void
+poller_iface::submit_accept(fd_t) {
+  __TACOPIE_THROW(error, "poller does not support completion-based operations");
+}
+
+bool
+poller_iface::take_completion(fd_t, int, std::size_t, completion&) {
+  __TACOPIE_THROW(error, "poller does not support completion-based operations");
+}
+
+//!
+//! poller creation
+//!
+
+std::unique_ptr<poller_iface>
+create_poller(poller_type type) {
+  switch (type) {
+  case poller_type::io_uring:
+#ifdef __TACOPIE_HAS_IO_URING
+    try {
+      return std::unique_ptr<poller_iface>(new io_uring_poller);
+    }
+    catch (const tacopie_error&) {
+      __TACOPIE_LOG(warn, "io_uring is not supported by the kernel, falling back to epoll");
+    }
+#else
+    __TACOPIE_LOG(warn, "io_uring is not available on this platform, falling back to epoll");
+#endif /* __TACOPIE_HAS_IO_URING */
+  //! fallthrough
+
+  case poller_type::epoll:
+#ifdef __linux__
+    return std::unique_ptr<poller_iface>(new epoll_poller);
+#else
+    if (type == poller_type::epoll) { __TACOPIE_LOG(warn, "epoll is not available on this platform, falling back to poll"); }
+#endif /* __linux__ */
+  //! fallthrough
+
+  case poller_type::poll:
+#ifndef _WIN32
+    return std::unique_ptr<poller_iface>(new poll_poller);
+#else
+    if (type == poller_type::poll) { __TACOPIE_LOG(warn, "poll is not available on this platform, falling back to select"); }
+#endif /* _WIN32 */
+  //! fallthrough
+
+  case poller_type::select:
+  default:
+    return std::unique_ptr<poller_iface>(new select_poller);
+  }
+}
+
+} // namespace tacopie
@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/network/select_poller.hpp>
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+
+namespace tacopie {
+
+//!
+//! ctor
+//!
+
+select_poller::select_poller(void) {
+  __TACOPIE_LOG(debug, "create select_poller");
+
+  FD_ZERO(&m_rd_set);
+  FD_ZERO(&m_wr_set);
+}
+
+//!
+//! register, update & unregister fds
+//!
+
+void
+select_poller::add(fd_t fd, int events, bool persistent) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+#ifdef _WIN32
+  if (m_fds.size() >= FD_SETSIZE) { __TACOPIE_THROW(error, "select_poller: too many fds, FD_SETSIZE exceeded"); }
+#else
+  if (fd >= FD_SETSIZE) { __TACOPIE_THROW(error, "select_poller: fd exceeds FD_SETSIZE"); }
+#endif /* _WIN32 */
+
+  m_fds[fd] = persistent;
+  set_fd_events(fd, events);
+}
+
+void
+select_poller::modify(fd_t fd, int events) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  if (m_fds.find(fd) == m_fds.end()) { return; }
+
+  set_fd_events(fd, events);
+}
+
+void
+select_poller::remove(fd_t fd) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  set_fd_events(fd, no_event);
+  m_fds.erase(fd);
+}
+
+void
+select_poller::set_fd_events(fd_t fd, int events) {
+  if (events & rd_event) {
+    FD_SET(fd, &m_rd_set);
+  }
+  else {
+    FD_CLR(fd, &m_rd_set);
+  }
+
+  if (events & wr_event) {
+    FD_SET(fd, &m_wr_set);
+  }
+  else {
+    FD_CLR(fd, &m_wr_set);
+  }
+
+  //! err_event is ignored: out-of-band data in the exception set would be mistaken for an error
+}
+
+//!
+//! wait for events
+//!
+
+void
+select_poller::wait(std::vector<event>& events, int timeout_msecs) {
+  events.clear();
+
+  //! select modifies the sets it is given, so work on a copy of the master sets
+  fd_set rd_set;
+  fd_set wr_set;
+  int nfds = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+    rd_set = m_rd_set;
+    wr_set = m_wr_set;
+
+    for (const auto& fd : m_fds) {
+      if ((int) fd.first >= nfds) { nfds = (int) fd.first + 1; }
+    }
+  }
+
+  //! setup timeout
+  struct timeval timeout;
+  struct timeval* timeout_ptr = NULL;
+  if (timeout_msecs >= 0) {
+    timeout.tv_sec  = timeout_msecs / 1000;
+    timeout.tv_usec = (timeout_msecs % 1000) * 1000;
+    timeout_ptr     = &timeout;
+  }
+
+  if (select(nfds, &rd_set, &wr_set, NULL, timeout_ptr) <= 0) { return; }
+
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  for (const auto& fd : m_fds) {
+    int reported = no_event;
+
+    if (FD_ISSET(fd.first, &rd_set)) { reported |= rd_event; }
+    if (FD_ISSET(fd.first, &wr_set)) { reported |= wr_event; }
+
+    if (reported == no_event) { continue; }
+
+    events.push_back({fd.first, reported});
+
+    //! one-shot: disarm until modify() is called
+    if (!fd.second) { set_fd_events(fd.first, no_event); }
+  }
+}
+
+poller_type
+select_poller::get_type(void) const {
+  return poller_type::select;
+}
+
+} // namespace tacopie
@@ -24,6 +24,10 @@
 #include <tacopie/utils/error.hpp>
 #include <tacopie/utils/logger.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
 #ifdef _WIN32
 #ifdef __GNUC__
 #   include <Ws2tcpip.h>	   // Mingw / gcc on windows
@@ -124,6 +128,26 @@ tcp_socket::recv(std::size_t size_to_read) {
   return data;
 }
 
+bool
+tcp_socket::is_remotely_closed(void) {
+  create_socket_if_necessary();
+  check_or_set_type(type::CLIENT);
+
+  char byte;
+#ifdef MSG_DONTWAIT
+  ssize_t rd_size = ::recv(m_fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+
+  //! nothing to read yet, and no EOF either
+  if (rd_size == SOCKET_ERROR && (errno == EAGAIN || errno == EWOULDBLOCK)) { return false; }
+#else
+  ssize_t rd_size = ::recv(m_fd, &byte, 1, MSG_PEEK);
+#endif /* MSG_DONTWAIT */
+
+  if (rd_size == SOCKET_ERROR) { __TACOPIE_THROW(error, "recv() failure"); }
+
+  return rd_size == 0;
+}
+
 std::size_t
 tcp_socket::send(const std::vector<char>& data, std::size_t size_to_write) {
   create_socket_if_necessary();
@@ -148,19 +172,12 @@ tcp_socket::listen(std::size_t max_connection_queue) {
   if (::listen(m_fd, __TACOPIE_LENGTH(max_connection_queue)) == SOCKET_ERROR) { __TACOPIE_THROW(debug, "listen() failure"); }
 }
 
-tcp_socket
-tcp_socket::accept(void) {
-  create_socket_if_necessary();
-  check_or_set_type(type::SERVER);
-
-  struct sockaddr_storage ss;
-  socklen_t addrlen = sizeof(ss);
-
-  fd_t client_fd = ::accept(m_fd, reinterpret_cast<struct sockaddr*>(&ss), &addrlen);
-
-  if (client_fd == __TACOPIE_INVALID_FD) { __TACOPIE_THROW(error, "accept() failure"); }
+//!
+//! build the tcp_socket of an accepted connection, determining host and port from the address of the peer
+//!
 
-  //! now determine host and port based on socket type
+static tcp_socket
+make_accepted_socket(fd_t client_fd, struct sockaddr_storage& ss) {
   std::string saddr;
   std::uint32_t port;
 
@@ -188,7 +205,36 @@ tcp_socket::accept(void) {
 
     port = ntohs(addr4->sin_port);
   }
-  return {client_fd, saddr, port, type::CLIENT};
+  return {client_fd, saddr, port, tcp_socket::type::CLIENT};
+}
+
+tcp_socket
+tcp_socket::accept(void) {
+  create_socket_if_necessary();
+  check_or_set_type(type::SERVER);
+
+  struct sockaddr_storage ss;
+  socklen_t addrlen = sizeof(ss);
+
+  fd_t client_fd = ::accept(m_fd, reinterpret_cast<struct sockaddr*>(&ss), &addrlen);
+
+  if (client_fd == __TACOPIE_INVALID_FD) { __TACOPIE_THROW(error, "accept() failure"); }
+
+  //! now determine host and port based on socket type
+  return make_accepted_socket(client_fd, ss);
+}
+
+tcp_socket
+tcp_socket::accept(const poller_iface::completion& completion) {
+  check_or_set_type(type::SERVER);
+
+  if (completion.result < 0) { __TACOPIE_THROW(error, "accept() failure"); }
+
+  struct sockaddr_storage ss;
+  std::memset(&ss, 0, sizeof(ss));
+  if (!completion.buffer.empty()) { std::memcpy(&ss, completion.buffer.data(), std::min(completion.buffer.size(), sizeof(ss))); }
+
+  return make_accepted_socket(static_cast<fd_t>(completion.result), ss);
 }
 
 //!
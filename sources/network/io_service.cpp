@@ -22,13 +22,16 @@
 
 #include <tacopie/network/io_service.hpp>
 #include <tacopie/utils/error.hpp>
+#include <tacopie/utils/flight_recorder.hpp>
 #include <tacopie/utils/logger.hpp>
+#include <tacopie/utils/thread_config.hpp>
 
 #include <fcntl.h>
 
 #ifdef _WIN32
 #include <io.h>
 #else
+#include <sys/socket.h>
 #include <unistd.h>
 #endif /* _WIN32 */
 
@@ -55,21 +58,87 @@ set_default_io_service(const std::shared_ptr<io_service>& service) {
   io_service_default_instance = service;
 }
 
+//!
+//! timeout of the waits on the poller when no timer is pending (__TACOPIE_TIMEOUT is expressed in microseconds)
+//!
+
+static int
+default_poll_timeout_msecs(void) {
+#ifdef __TACOPIE_TIMEOUT
+  return (__TACOPIE_TIMEOUT + 999) / 1000;
+#else
+  return -1;
+#endif /* __TACOPIE_TIMEOUT */
+}
+
+//!
+//! statistics are only updated by the thread running the loop: a plain load and store is enough (no atomic read-modify-write)
+//!
+
+static void
+add_to_counter(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static std::uint64_t
+elapsed_nsecs(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end) {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
 //!
 //! ctor & dtor
 //!
 
 io_service::io_service(void)
+: io_service(poller_type::__TACOPIE_DEFAULT_POLLER) {}
+
+io_service::io_service(poller_type type)
+: io_service(type, loop_mode::background_thread) {}
+
+io_service::io_service(poller_type type, loop_mode mode)
 #ifdef _WIN32
 : m_should_stop(ATOMIC_VAR_INIT(false))
 #else
 : m_should_stop(false)
 #endif /* _WIN32 */
-, m_callback_workers(__TACOPIE_IO_SERVICE_NB_WORKERS) {
+, m_loop_mode(mode)
+, m_loop_thread_id(std::thread::id())
+, m_callback_workers(mode == loop_mode::background_thread ? __TACOPIE_IO_SERVICE_NB_WORKERS : 0)
+, m_callback_mode(mode == loop_mode::background_thread ? callback_mode::workers : callback_mode::poll_thread)
+, m_poller(create_poller(type))
+, m_max_events_per_iteration(__TACOPIE_IO_SERVICE_MAX_EVENTS_PER_ITERATION)
+, m_high_priority_share(__TACOPIE_THREAD_POOL_HIGH_PRIORITY_SHARE)
+, m_nb_consecutive_high_priority_events(0)
+, m_poll_deadline(utils::timer_wheel::clock_t::time_point::min())
+, m_wakeup_pending(false)
+, m_nb_wakeups(0)
+, m_nb_suppressed_wakeups(0)
+, m_busy_poll_spin_usecs(0)
+, m_busy_poll_max_spins(0)
+, m_socket_busy_poll_usecs(0)
+, m_nb_busy_poll_hits(0)
+, m_nb_busy_poll_misses(0)
+, m_nb_iterations(0)
+, m_nb_events(0)
+, m_max_events_per_wakeup(0)
+, m_wait_time_nsecs(0)
+, m_processing_time_nsecs(0)
+, m_nb_carried_over_events(0)
+, m_nb_tracked_sockets(0)
+, m_latency_tracking(false) {
   __TACOPIE_LOG(debug, "create io_service");
 
+  //! the notifier is the only fd that stays armed after reporting an event
+  m_poller->add(m_notifier.get_read_fd(), poller_iface::rd_event, true);
+
+  //! named threads are easier to spot in top or perf
+  m_callback_workers.set_workers_name("tacopie-wrk");
+
   //! Start worker after everything has been initialized
-  m_poll_worker = std::thread(std::bind(&io_service::poll, this));
+  if (m_loop_mode == loop_mode::background_thread) {
+    m_poll_worker = std::thread(std::bind(&io_service::poll, this));
+    utils::set_thread_name(m_poll_worker, "tacopie-poll");
+  }
 }
 
 io_service::~io_service(void) {
@@ -92,6 +161,195 @@ io_service::set_nb_workers(std::size_t nb_threads) {
   m_callback_workers.set_nb_threads(nb_threads);
 }
 
+poller_type
+io_service::get_poller_type(void) const {
+  return m_poller->get_type();
+}
+
+void
+io_service::set_poll_thread_affinity(const std::vector<std::size_t>& cpus) {
+  if (m_loop_mode != loop_mode::background_thread) { __TACOPIE_THROW(error, "io_service has no poll thread"); }
+
+  utils::set_thread_affinity(m_poll_worker, cpus);
+}
+
+void
+io_service::set_poll_thread_name(const std::string& name) {
+  if (m_loop_mode != loop_mode::background_thread) { __TACOPIE_THROW(error, "io_service has no poll thread"); }
+
+  utils::set_thread_name(m_poll_worker, name);
+}
+
+void
+io_service::set_workers_affinity(const std::vector<std::vector<std::size_t>>& cpus) {
+  m_callback_workers.set_workers_affinity(cpus);
+}
+
+void
+io_service::set_workers_name(const std::string& name) {
+  m_callback_workers.set_workers_name(name);
+}
+
+std::size_t
+io_service::get_nb_tracked_sockets(void) const {
+  return m_nb_tracked_sockets;
+}
+
+std::uint64_t
+io_service::get_nb_wakeups(void) const {
+  return m_nb_wakeups;
+}
+
+std::uint64_t
+io_service::get_nb_suppressed_wakeups(void) const {
+  return m_nb_suppressed_wakeups;
+}
+
+void
+io_service::set_max_events_per_iteration(std::size_t max_events) {
+  m_max_events_per_iteration = max_events;
+}
+
+//!
+//! busy polling
+//!
+
+void
+io_service::set_busy_poll(std::uint32_t spin_usecs, std::uint32_t max_spins, std::uint32_t socket_busy_poll_usecs) {
+  m_busy_poll_spin_usecs   = spin_usecs;
+  m_busy_poll_max_spins    = max_spins;
+  m_socket_busy_poll_usecs = socket_busy_poll_usecs;
+}
+
+std::uint64_t
+io_service::get_nb_busy_poll_hits(void) const {
+  return m_nb_busy_poll_hits;
+}
+
+std::uint64_t
+io_service::get_nb_busy_poll_misses(void) const {
+  return m_nb_busy_poll_misses;
+}
+
+bool
+io_service::busy_poll(int default_timeout_msecs) {
+  std::uint32_t spin_usecs = m_busy_poll_spin_usecs;
+  std::uint32_t max_spins  = m_busy_poll_max_spins;
+
+  if (!spin_usecs && !max_spins) { return false; }
+
+  //! the timeout of the blocking wait is computed again after spinning, as timers may have expired in the meantime
+  int timeout_msecs = get_poll_timeout(default_timeout_msecs);
+  if (timeout_msecs == 0) { return false; }
+
+  //! never spin longer than the blocking wait would last
+  std::chrono::microseconds budget(spin_usecs);
+  if (timeout_msecs > 0 && (!spin_usecs || budget > std::chrono::milliseconds(timeout_msecs))) { budget = std::chrono::milliseconds(timeout_msecs); }
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (std::uint32_t nb_spins = 0; !max_spins || nb_spins < max_spins; ++nb_spins) {
+    m_poller->wait(m_events, 0);
+
+    if (!m_events.empty()) {
+      add_to_counter(m_nb_busy_poll_hits, 1);
+      return true;
+    }
+
+    if (budget.count() && std::chrono::steady_clock::now() - start >= budget) { break; }
+  }
+
+  add_to_counter(m_nb_busy_poll_misses, 1);
+  return false;
+}
+
+void
+io_service::set_socket_busy_poll(const fd_t& fd) {
+#ifdef SO_BUSY_POLL
+  int busy_poll_usecs = m_socket_busy_poll_usecs;
+
+  if (!busy_poll_usecs) { return; }
+
+  //! best effort: values above net.core.busy_read require CAP_NET_ADMIN
+  if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_usecs, sizeof(busy_poll_usecs)) == -1) {
+    __TACOPIE_LOG(warn, "failed to set SO_BUSY_POLL on tracked socket");
+  }
+#else
+  (void) fd;
+#endif /* SO_BUSY_POLL */
+}
+
+//!
+//! callback mode
+//!
+
+void
+io_service::set_callback_mode(callback_mode mode) {
+  m_callback_mode = mode;
+}
+
+void
+io_service::set_fd_callback_mode(fd_t fd, callback_mode mode) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto& track_info = get_tracked_socket(fd);
+  track_info.mode  = mode;
+}
+
+void
+io_service::set_callback_mode(const tcp_socket& socket, callback_mode mode) {
+  set_fd_callback_mode(socket.get_fd(), mode);
+}
+
+//!
+//! priorities
+//!
+
+void
+io_service::set_fd_priority(fd_t fd, priority fd_priority) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto& track_info           = get_tracked_socket(fd);
+  track_info.socket_priority = fd_priority;
+}
+
+void
+io_service::set_priority(const tcp_socket& socket, priority socket_priority) {
+  set_fd_priority(socket.get_fd(), socket_priority);
+}
+
+void
+io_service::set_high_priority_share(std::size_t share) {
+  m_high_priority_share = share;
+  m_callback_workers.set_high_priority_share(share);
+}
+
+//!
+//! strands
+//!
+
+std::shared_ptr<utils::strand>
+io_service::make_strand(priority strand_priority) {
+  if (m_loop_mode == loop_mode::caller_thread) {
+    return std::make_shared<utils::strand>([this](task_t&& task) { post(std::move(task)); });
+  }
+
+  return std::make_shared<utils::strand>([this, strand_priority](task_t&& task) { m_callback_workers.add_task(std::move(task), strand_priority); });
+}
+
+void
+io_service::set_fd_strand(fd_t fd, const std::shared_ptr<utils::strand>& strand) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto& track_info  = get_tracked_socket(fd);
+  track_info.strand = strand;
+}
+
+void
+io_service::set_strand(const tcp_socket& socket, const std::shared_ptr<utils::strand>& strand) {
+  set_fd_strand(socket.get_fd(), strand);
+}
+
 
 //!
 //! poll worker function
@@ -101,27 +359,293 @@ void
 io_service::poll(void) {
   __TACOPIE_LOG(debug, "starting poll() worker");
 
-  while (!m_should_stop) {
-    int ndfs = init_poll_fds_info();
+  m_loop_thread_id = std::this_thread::get_id();
 
-    //! setup timeout
-    struct timeval* timeout_ptr = NULL;
-#ifdef __TACOPIE_TIMEOUT
-    struct timeval timeout;
-    timeout.tv_usec = __TACOPIE_TIMEOUT;
-    timeout_ptr     = &timeout;
-#endif /* __TACOPIE_TIMEOUT */
+  int timeout_msecs = default_poll_timeout_msecs();
+
+  while (!m_should_stop) { run_iteration(timeout_msecs); }
+
+  __TACOPIE_LOG(debug, "stop poll() worker");
+}
 
+void
+io_service::run_iteration(int default_timeout_msecs) {
+  auto start = std::chrono::steady_clock::now();
+
+  apply_pending_updates();
+
+  //! room for an event per tracked fd (plus the notifier), so that waiting does not allocate in steady state
+  std::size_t max_nb_events = m_nb_tracked_sockets.load(std::memory_order_relaxed) + 1;
+  if (m_events.capacity() < max_nb_events) { m_events.reserve(max_nb_events); }
+
+  auto wait_start = std::chrono::steady_clock::now();
+
+  if (has_ready_events()) {
+    //! events have been carried over: only check for new ones
+    m_poller->wait(m_events, 0);
+  }
+  else if (!busy_poll(default_timeout_msecs)) {
     __TACOPIE_LOG(debug, "polling fds");
-    if (select(ndfs, &m_rd_set, &m_wr_set, NULL, timeout_ptr) > 0) {
-      process_events();
+    m_poller->wait(m_events, get_poll_timeout(default_timeout_msecs));
+  }
+
+  auto wait_end   = std::chrono::steady_clock::now();
+  m_last_wait_end = wait_end;
+
+  process_timers();
+
+  if (!m_events.empty() || has_ready_events()) {
+    process_events();
+  }
+  else {
+    __TACOPIE_LOG(debug, "poll woke up, but nothing to process");
+  }
+
+  process_posted_tasks();
+
+  auto end = std::chrono::steady_clock::now();
+
+  add_to_counter(m_nb_iterations, 1);
+  add_to_counter(m_wait_time_nsecs, elapsed_nsecs(wait_start, wait_end));
+  add_to_counter(m_processing_time_nsecs, elapsed_nsecs(start, wait_start) + elapsed_nsecs(wait_end, end));
+}
+
+//!
+//! latency tracking
+//!
+
+void
+io_service::set_latency_tracking(bool enabled) {
+  m_latency_tracking = enabled;
+}
+
+const io_service::latency_histograms&
+io_service::get_latency_histograms(void) const {
+  return m_latency_histograms;
+}
+
+void
+io_service::set_latency_tracking(const tcp_socket& socket, bool enabled) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto& track_info = get_tracked_socket(socket.get_fd());
+
+  if (!enabled) {
+    track_info.latency = nullptr;
+  }
+  else if (!track_info.latency) {
+    track_info.latency = std::make_shared<latency_histograms>();
+  }
+}
+
+std::shared_ptr<const io_service::latency_histograms>
+io_service::get_latency_histograms(const tcp_socket& socket) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto socket_ptr = m_tracked_sockets.find(socket.get_fd());
+
+  return socket_ptr ? socket_ptr->latency : nullptr;
+}
+
+//!
+//! statistics
+//!
+
+io_service::stats
+io_service::get_stats(void) const {
+  stats snapshot;
+
+  snapshot.nb_iterations          = m_nb_iterations;
+  snapshot.nb_events              = m_nb_events;
+  snapshot.max_events_per_wakeup  = m_max_events_per_wakeup;
+  snapshot.wait_time_nsecs        = m_wait_time_nsecs;
+  snapshot.processing_time_nsecs  = m_processing_time_nsecs;
+  snapshot.nb_wakeups             = m_nb_wakeups;
+  snapshot.nb_suppressed_wakeups  = m_nb_suppressed_wakeups;
+  snapshot.nb_busy_poll_hits      = m_nb_busy_poll_hits;
+  snapshot.nb_busy_poll_misses    = m_nb_busy_poll_misses;
+  snapshot.nb_tracked_sockets     = m_nb_tracked_sockets;
+  snapshot.nb_pending_callbacks   = m_callback_workers.get_nb_pending_tasks();
+  snapshot.nb_carried_over_events = m_nb_carried_over_events;
+
+  return snapshot;
+}
+
+//!
+//! caller-driven poll loop
+//!
+
+void
+io_service::run(void) {
+  enter_loop();
+
+  try {
+    int timeout_msecs = default_poll_timeout_msecs();
+
+    while (!m_should_stop) { run_iteration(timeout_msecs); }
+  }
+  catch (...) {
+    leave_loop();
+    throw;
+  }
+
+  //! consume the stop request
+  m_should_stop = false;
+
+  leave_loop();
+}
+
+void
+io_service::run_once(int timeout_msecs) {
+  enter_loop();
+
+  try {
+    run_iteration(timeout_msecs);
+  }
+  catch (...) {
+    leave_loop();
+    throw;
+  }
+
+  leave_loop();
+}
+
+void
+io_service::poll_once(void) {
+  run_once(0);
+}
+
+void
+io_service::stop(void) {
+  if (m_loop_mode != loop_mode::caller_thread) { __TACOPIE_THROW(error, "io_service is driven by its poll thread"); }
+
+  m_should_stop = true;
+  wake_up();
+}
+
+void
+io_service::enter_loop(void) {
+  if (m_loop_mode != loop_mode::caller_thread) { __TACOPIE_THROW(error, "io_service is driven by its poll thread"); }
+
+  std::thread::id no_thread;
+  if (!m_loop_thread_id.compare_exchange_strong(no_thread, std::this_thread::get_id())) { __TACOPIE_THROW(error, "io_service loop is already being run"); }
+}
+
+void
+io_service::leave_loop(void) {
+  m_loop_thread_id = std::thread::id();
+}
+
+//!
+//! timers
+//!
+
+io_service::timer_id_t
+io_service::schedule_after(std::uint32_t timeout_msecs, const timer_callback_t& callback) {
+  std::lock_guard<std::mutex> lock(m_timers_mtx);
+
+  auto now = utils::timer_wheel::clock_t::now();
+  auto id  = m_timers.schedule_after(timeout_msecs, callback, now);
+
+  //! the poll thread sleeps beyond the expiry of the new timer
+  if (now + std::chrono::milliseconds(timeout_msecs) < m_poll_deadline) { wake_up(); }
+
+  return id;
+}
+
+bool
+io_service::cancel(timer_id_t id) {
+  std::lock_guard<std::mutex> lock(m_timers_mtx);
+
+  return m_timers.cancel(id);
+}
+
+int
+io_service::get_poll_timeout(int default_timeout_msecs) {
+  std::lock_guard<std::mutex> lock(m_timers_mtx);
+
+  auto now           = utils::timer_wheel::clock_t::now();
+  int timeout_msecs  = default_timeout_msecs;
+  int timers_timeout = m_timers.get_next_expiry_msecs(now);
+
+  if (timers_timeout >= 0 && (timeout_msecs < 0 || timers_timeout < timeout_msecs)) { timeout_msecs = timers_timeout; }
+
+  if (timeout_msecs < 0) {
+    m_poll_deadline = utils::timer_wheel::clock_t::time_point::max();
+  }
+  else {
+    m_poll_deadline = now + std::chrono::milliseconds(timeout_msecs);
+  }
+
+  return timeout_msecs;
+}
+
+void
+io_service::process_timers(void) {
+  {
+    std::lock_guard<std::mutex> lock(m_timers_mtx);
+
+    //! the poll thread is awake: timers scheduled from now on are taken into account before the next wait
+    m_poll_deadline = utils::timer_wheel::clock_t::time_point::min();
+
+    //! advanced even when empty (in O(1)), so that the wheel keeps up with the clock
+    m_timers.advance(m_expired_timers);
+  }
+
+  for (auto& callback : m_expired_timers) {
+    if (m_callback_mode == callback_mode::poll_thread || !has_callback_workers()) {
+      execute_task(std::move(callback));
     }
     else {
-      __TACOPIE_LOG(debug, "poll woke up, but nothing to process");
+      m_callback_workers << std::move(callback);
     }
   }
 
-  __TACOPIE_LOG(debug, "stop poll() worker");
+  m_expired_timers.clear();
+}
+
+//!
+//! posted tasks
+//!
+
+void
+io_service::post(task_t task) {
+  m_posted_tasks.push(std::move(task));
+  wake_up();
+}
+
+void
+io_service::dispatch(task_t task) {
+  if (std::this_thread::get_id() == m_loop_thread_id.load()) {
+    execute_task(task);
+  }
+  else {
+    post(std::move(task));
+  }
+}
+
+void
+io_service::process_posted_tasks(void) {
+  task_t task;
+
+  for (std::size_t i = 0; i < __TACOPIE_IO_SERVICE_MAX_POSTED_TASKS_BATCH; ++i) {
+    if (!m_posted_tasks.pop(task)) { return; }
+
+    execute_task(task);
+  }
+
+  //! batch limit reached: make sure the next wait does not block while tasks are left
+  wake_up();
+}
+
+void
+io_service::execute_task(const task_t& task) {
+  try {
+    task();
+  }
+  catch (const std::exception&) {
+    __TACOPIE_LOG(warn, "uncatched exception propagated up to the poll thread.")
+  }
 }
 
 //!
@@ -130,202 +654,526 @@ io_service::poll(void) {
 
 void
 io_service::process_events(void) {
-  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+  std::unique_lock<std::mutex> lock(m_tracked_sockets_mtx);
 
   __TACOPIE_LOG(debug, "processing events");
 
-  for (const auto& fd : m_polled_fds) {
-    if (fd == m_notifier.get_read_fd() && FD_ISSET(fd, &m_rd_set)) {
+  std::uint64_t nb_new_events = 0;
+
+  for (const auto& event : m_events) {
+    if (event.fd == m_notifier.get_read_fd()) {
+      __TACOPIE_RECORD(notifier_wake, event.fd, 0);
       m_notifier.clr_buffer();
+
+      //! cleared after draining the notifier and before the pending work (such as queued updates) is read: a wake up requested from now on must notify again
+      //! exchange (rather than store) so that the work queued before the last wake up request is visible
+      m_wakeup_pending.exchange(false);
       continue;
     }
 
-    auto it = m_tracked_sockets.find(fd);
+    ++nb_new_events;
 
-    if (it == m_tracked_sockets.end()) { continue; }
+    auto socket_ptr = m_tracked_sockets.find(event.fd);
+    if (!socket_ptr) { continue; }
 
-    auto& socket = it->second;
+    //! queued behind the events carried over from the previous iterations
+    ready_event ready = {event.fd, event.events, m_tracked_sockets.get_generation(event.fd), m_last_wait_end};
+    __TACOPIE_RECORD(ready, event.fd, static_cast<std::uint16_t>(event.events));
 
-    if (FD_ISSET(fd, &m_rd_set) && socket.rd_callback && !socket.is_executing_rd_callback) {
-      process_rd_event(fd, socket);
+    if (socket_ptr->socket_priority == priority::high) {
+      m_high_priority_ready_events.push(ready);
     }
-    if (FD_ISSET(fd, &m_wr_set) && socket.wr_callback && !socket.is_executing_wr_callback) {
-      process_wr_event(fd, socket);
+    else {
+      m_ready_events.push(ready);
     }
+  }
+
+  add_to_counter(m_nb_events, nb_new_events);
+  if (nb_new_events > m_max_events_per_wakeup.load(std::memory_order_relaxed)) { m_max_events_per_wakeup.store(nb_new_events, std::memory_order_relaxed); }
+
+  std::size_t nb_ready_events = m_ready_events.size() + m_high_priority_ready_events.size();
+  std::size_t nb_events       = m_max_events_per_iteration;
+  if (!nb_events || nb_events > nb_ready_events) { nb_events = nb_ready_events; }
 
-    if (socket.marked_for_untrack && !socket.is_executing_rd_callback && !socket.is_executing_wr_callback) {
-      __TACOPIE_LOG(debug, "untrack socket");
-      m_tracked_sockets.erase(it);
-      m_wait_for_removal_condvar.notify_all();
+  for (std::size_t i = 0; i < nb_events; ++i) {
+    //! let track, untrack and set_*_callback callers in between chunks
+    if (i && i % __TACOPIE_IO_SERVICE_EVENTS_CHUNK_SIZE == 0) {
+      lock.unlock();
+      if (!m_inline_callbacks.empty()) { execute_inline_callbacks(); }
+      lock.lock();
     }
+
+    auto event = pop_ready_event();
+
+    const auto& fd  = event.fd;
+    auto socket_ptr = m_tracked_sockets.find(fd, event.generation);
+
+    //! untracked in the meantime (possibly while the lock was released, or while the event was carried over)
+    if (!socket_ptr) { continue; }
+
+    auto& socket = *socket_ptr;
+
+    //! the poller disarmed the fd when reporting the event
+    socket.polled_events = poller_iface::no_event;
+
+    bool is_dispatched = false;
+
+    if ((event.events & poller_iface::rd_event) && socket.rd_callback && !socket.is_executing_rd_callback) {
+      dispatch_callback(fd, socket, poller_iface::rd_event, event.reported_at);
+      is_dispatched = true;
+    }
+    if ((event.events & poller_iface::wr_event) && socket.wr_callback && !socket.is_executing_wr_callback) {
+      dispatch_callback(fd, socket, poller_iface::wr_event, event.reported_at);
+      is_dispatched = true;
+    }
+
+    //! errors are only delivered to idle sockets: a dispatched read or write callback reports the failure by itself
+    if (!is_dispatched && (event.events & (poller_iface::err_event | poller_iface::hup_event)) && socket.err_callback && !socket.is_executing_callback()) {
+      dispatch_callback(fd, socket, poller_iface::err_event, event.reported_at);
+    }
+
+    //! re-arm for the events that have not been dispatched (if any)
+    update_polled_events(fd, socket);
   }
+
+  m_nb_carried_over_events.store(m_ready_events.size() + m_high_priority_ready_events.size(), std::memory_order_relaxed);
+
+  lock.unlock();
+
+  if (!m_inline_callbacks.empty()) { execute_inline_callbacks(); }
+}
+
+bool
+io_service::has_ready_events(void) const {
+  return !m_ready_events.empty() || !m_high_priority_ready_events.empty();
+}
+
+io_service::ready_event
+io_service::pop_ready_event(void) {
+  std::size_t share = m_high_priority_share;
+  ready_event event;
+
+  //! same policy as the callback workers: high priority first, unless they already used their share while normal priority events are waiting
+  if (!m_high_priority_ready_events.empty() && (m_ready_events.empty() || !share || m_nb_consecutive_high_priority_events < share)) {
+    event = m_high_priority_ready_events.front();
+    m_high_priority_ready_events.pop();
+
+    if (!m_ready_events.empty()) { ++m_nb_consecutive_high_priority_events; }
+  }
+  else {
+    event = m_ready_events.front();
+    m_ready_events.pop();
+
+    m_nb_consecutive_high_priority_events = 0;
+  }
+
+  return event;
 }
 
 void
-io_service::process_rd_event(const fd_t& fd, tracked_socket& socket) {
-  __TACOPIE_LOG(debug, "processing read event");
+io_service::dispatch_callback(const fd_t& fd, tracked_socket& socket, int event, const std::chrono::steady_clock::time_point& reported_at) {
+  __TACOPIE_LOG(debug, event == poller_iface::rd_event ? "processing read event" : event == poller_iface::wr_event ? "processing write event" : "processing error event");
+  __TACOPIE_RECORD(dispatch, fd, static_cast<std::uint16_t>(event));
 
-  auto rd_callback = socket.rd_callback;
+  latency_histograms* service_latency = m_latency_tracking.load(std::memory_order_relaxed) ? &m_latency_histograms : nullptr;
 
-  socket.is_executing_rd_callback = true;
+  //! the callback is moved out of the tracked socket rather than copied: it is given back by complete_callback
+  dispatched_callback dispatched = {nullptr, m_tracked_sockets.get_generation(fd), reported_at, service_latency, socket.latency, fd, event};
 
-  m_callback_workers << [=] {
-    __TACOPIE_LOG(debug, "execute read callback");
-    rd_callback(fd);
+  if (event == poller_iface::rd_event) {
+    dispatched.callback             = std::move(socket.rd_callback);
+    socket.is_executing_rd_callback = true;
+    socket.is_rd_callback_lent      = true;
+  }
+  else if (event == poller_iface::wr_event) {
+    dispatched.callback             = std::move(socket.wr_callback);
+    socket.is_executing_wr_callback = true;
+    socket.is_wr_callback_lent      = true;
+  }
+  else {
+    dispatched.callback              = std::move(socket.err_callback);
+    socket.is_executing_err_callback = true;
+    socket.is_err_callback_lent      = true;
+  }
 
-    std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
-    auto it = m_tracked_sockets.find(fd);
+  //! without workers, callback_mode::workers falls back to the thread running the loop
+  if ((socket.mode == callback_mode::poll_thread || !has_callback_workers()) && !socket.strand) {
+    m_inline_callbacks.push_back(std::move(dispatched));
+    return;
+  }
 
-    if (it == m_tracked_sockets.end()) { return; }
+  execute_on_workers(socket, callback_task{std::move(dispatched), this});
+}
 
-    auto& socket                    = it->second;
-    socket.is_executing_rd_callback = false;
+void
+io_service::execute_callback(dispatched_callback& dispatched, bool from_poll_thread) {
+  __TACOPIE_LOG(debug, dispatched.event == poller_iface::rd_event ? "execute read callback" : dispatched.event == poller_iface::wr_event ? "execute write callback" : "execute error callback");
+
+  bool measure_latency = dispatched.service_latency || dispatched.socket_latency;
+  std::chrono::steady_clock::time_point start;
+  if (measure_latency) { start = std::chrono::steady_clock::now(); }
+
+  __TACOPIE_RECORD(callback_start, dispatched.fd, static_cast<std::uint16_t>(dispatched.event));
+
+  //! the callback must be completed even if it throws, otherwise the socket would never be polled again
+  try {
+    dispatched.callback(dispatched.fd);
+  }
+  catch (const std::exception&) {
+    __TACOPIE_LOG(warn, "uncatched exception propagated up to the io_service.")
+  }
+
+  __TACOPIE_RECORD(callback_end, dispatched.fd, static_cast<std::uint16_t>(dispatched.event));
 
-    if (socket.marked_for_untrack && !socket.is_executing_wr_callback) {
-      __TACOPIE_LOG(debug, "untrack socket");
-      m_tracked_sockets.erase(it);
-      m_wait_for_removal_condvar.notify_all();
+  if (measure_latency) {
+    auto end = std::chrono::steady_clock::now();
+
+    auto dispatch_latency = elapsed_nsecs(dispatched.reported_at, start);
+    auto callback_time    = elapsed_nsecs(start, end);
+
+    if (dispatched.service_latency) {
+      dispatched.service_latency->dispatch_latency.record(dispatch_latency);
+      dispatched.service_latency->callback_time.record(callback_time);
+    }
+
+    if (dispatched.socket_latency) {
+      dispatched.socket_latency->dispatch_latency.record(dispatch_latency);
+      dispatched.socket_latency->callback_time.record(callback_time);
     }
+  }
+
+  complete_callback(dispatched.fd, dispatched.generation, dispatched.event, from_poll_thread, dispatched.callback);
+}
 
-    m_notifier.notify();
-  };
+bool
+io_service::has_callback_workers(void) const {
+  return m_callback_workers.get_nb_threads() != 0;
 }
 
 void
-io_service::process_wr_event(const fd_t& fd, tracked_socket& socket) {
-  __TACOPIE_LOG(debug, "processing write event");
+io_service::execute_on_workers(const tracked_socket& socket, task_t task) {
+  if (socket.strand) {
+    *socket.strand << std::move(task);
+  }
+  else {
+    m_callback_workers.add_task(std::move(task), socket.socket_priority);
+  }
+}
 
-  auto wr_callback = socket.wr_callback;
+void
+io_service::execute_inline_callbacks(void) {
+  for (auto& inline_callback : m_inline_callbacks) {
+    __TACOPIE_LOG(debug, "execute callback on poll thread");
 
-  socket.is_executing_wr_callback = true;
+    execute_callback(inline_callback, true);
+  }
 
-  m_callback_workers << [=] {
-    __TACOPIE_LOG(debug, "execute write callback");
-    wr_callback(fd);
+  //! destroys the callbacks that have been replaced while being executed
+  m_inline_callbacks.clear();
+}
 
-    std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
-    auto it = m_tracked_sockets.find(fd);
+void
+io_service::complete_callback(const fd_t& fd, std::uint64_t generation, int event, bool from_poll_thread, event_callback_t& callback) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  //! the fd may have been untracked and reused for another socket in the meantime
+  auto socket_ptr = m_tracked_sockets.find(fd, generation);
+
+  if (!socket_ptr) { return; }
 
-    if (it == m_tracked_sockets.end()) { return; }
+  auto& socket = *socket_ptr;
 
-    auto& socket                    = it->second;
+  if (event == poller_iface::rd_event) {
+    if (socket.is_rd_callback_lent) { socket.rd_callback = std::move(callback); }
+
+    socket.is_rd_callback_lent      = false;
+    socket.is_executing_rd_callback = false;
+  }
+  else if (event == poller_iface::wr_event) {
+    if (socket.is_wr_callback_lent) { socket.wr_callback = std::move(callback); }
+
+    socket.is_wr_callback_lent      = false;
     socket.is_executing_wr_callback = false;
+  }
+  else {
+    if (socket.is_err_callback_lent) { socket.err_callback = std::move(callback); }
 
-    if (socket.marked_for_untrack && !socket.is_executing_rd_callback) {
-      __TACOPIE_LOG(debug, "untrack socket");
-      m_tracked_sockets.erase(it);
-      m_wait_for_removal_condvar.notify_all();
-    }
+    socket.is_err_callback_lent      = false;
+    socket.is_executing_err_callback = false;
+  }
 
-    m_notifier.notify();
-  };
+  if (socket.marked_for_untrack && !socket.is_executing_callback()) {
+    __TACOPIE_LOG(debug, "untrack socket");
+    erase_tracked_socket(fd);
+  }
+  else if (from_poll_thread) {
+    update_polled_events(fd, socket);
+  }
+  else {
+    queue_polled_events_update(fd, socket);
+  }
 }
 
 //!
-//! init m_poll_fds_info
+//! register & re-arm tracked sockets in the poller
 //!
 
-int
-io_service::init_poll_fds_info(void) {
-  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+void
+io_service::update_polled_events(const fd_t& fd, tracked_socket& socket) {
+  //! sockets marked for untrack have already been removed from the poller
+  if (socket.marked_for_untrack) { return; }
 
-  m_polled_fds.clear();
-  FD_ZERO(&m_rd_set);
-  FD_ZERO(&m_wr_set);
+  int events = poller_iface::no_event;
 
-  int ndfs = (int) m_notifier.get_read_fd();
-  FD_SET(m_notifier.get_read_fd(), &m_rd_set);
-  m_polled_fds.push_back(m_notifier.get_read_fd());
+  if (socket.rd_callback && !socket.is_executing_rd_callback) { events |= poller_iface::rd_event; }
+  if (socket.wr_callback && !socket.is_executing_wr_callback) { events |= poller_iface::wr_event; }
 
-  for (const auto& socket : m_tracked_sockets) {
-    const auto& fd          = socket.first;
-    const auto& socket_info = socket.second;
+  //! while a callback is being executed, a failure is reported by the callback itself (or on its completion)
+  if (socket.err_callback && !socket.is_executing_callback()) { events |= poller_iface::err_event; }
 
-    bool should_rd = socket_info.rd_callback && !socket_info.is_executing_rd_callback;
-    if (should_rd) {
-      FD_SET(fd, &m_rd_set);
-    }
+  if (!socket.is_registered) {
+    m_poller->add(fd, events, false);
+    socket.is_registered = true;
+  }
+  else if (events != socket.polled_events) {
+    m_poller->modify(fd, events);
+  }
 
-    bool should_wr = socket_info.wr_callback && !socket_info.is_executing_wr_callback;
-    if (should_wr) {
-      FD_SET(fd, &m_wr_set);
-    }
+  socket.polled_events = events;
+}
 
-    if (should_rd || should_wr || socket_info.marked_for_untrack) {
-      m_polled_fds.push_back(fd);
-    }
+void
+io_service::queue_polled_events_update(const fd_t& fd, tracked_socket& socket) {
+  if (socket.has_pending_update) { return; }
 
-    if ((should_rd || should_wr) && (int) fd > ndfs) {
-      ndfs = (int) fd;
-    }
+  socket.has_pending_update = true;
+  m_pending_updates.push_back(fd);
+
+  //! the poll thread is woken up once per batch of updates
+  if (m_pending_updates.size() == 1) { wake_up(); }
+}
+
+void
+io_service::wake_up(void) {
+  if (m_wakeup_pending.exchange(true)) {
+    ++m_nb_suppressed_wakeups;
+    return;
   }
 
-  return ndfs + 1;
+  ++m_nb_wakeups;
+  __TACOPIE_RECORD(wake_up, m_notifier.get_write_fd(), 0);
+  m_notifier.notify();
+}
+
+void
+io_service::apply_pending_updates(void) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  if (m_pending_updates.empty()) { return; }
+
+  std::swap(m_pending_updates, m_applied_updates);
+
+  for (const auto& fd : m_applied_updates) {
+    auto socket_ptr = m_tracked_sockets.find(fd);
+
+    //! the socket may have been untracked in the meantime
+    if (!socket_ptr || !socket_ptr->has_pending_update) { continue; }
+
+    socket_ptr->has_pending_update = false;
+    update_polled_events(fd, *socket_ptr);
+  }
+
+  m_applied_updates.clear();
 }
 
 //!
 //! track & untrack socket
 //!
 
+io_service::tracked_socket&
+io_service::get_tracked_socket(const fd_t& fd) {
+  auto socket_ptr = m_tracked_sockets.find(fd);
+
+  if (socket_ptr) { return *socket_ptr; }
+
+  auto& socket = m_tracked_sockets[fd];
+  socket.mode  = m_callback_mode;
+
+  m_nb_tracked_sockets = m_tracked_sockets.size();
+
+  return socket;
+}
+
 void
-io_service::track(const tcp_socket& socket, const event_callback_t& rd_callback, const event_callback_t& wr_callback) {
+io_service::erase_tracked_socket(const fd_t& fd) {
+  auto socket_ptr = m_tracked_sockets.find(fd);
+
+  if (!socket_ptr) { return; }
+
+  //! the entry is reset on erase: keep the promise alive until its waiters are notified
+  auto removal = std::move(socket_ptr->removal);
+
+  m_tracked_sockets.erase(fd);
+  m_nb_tracked_sockets = m_tracked_sockets.size();
+
+  if (removal) { removal->set_value(); }
+}
+
+void
+io_service::track_fd(fd_t fd, event_callback_t rd_callback, event_callback_t wr_callback, event_callback_t err_callback) {
   std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
 
   __TACOPIE_LOG(debug, "track new socket");
+  __TACOPIE_RECORD(track, fd, 0);
+
+  //! the fd has been reused while the callbacks of the previous socket are still running: start a new generation
+  auto previous = m_tracked_sockets.find(fd);
+  if (previous && previous->marked_for_untrack) { erase_tracked_socket(fd); }
+
+  auto& track_info                     = get_tracked_socket(fd);
+  track_info.rd_callback               = std::move(rd_callback);
+  track_info.wr_callback               = std::move(wr_callback);
+  track_info.err_callback              = std::move(err_callback);
+  track_info.marked_for_untrack        = false;
+  track_info.is_executing_rd_callback  = false;
+  track_info.is_executing_wr_callback  = false;
+  track_info.is_executing_err_callback = false;
+  track_info.is_rd_callback_lent       = false;
+  track_info.is_wr_callback_lent       = false;
+  track_info.is_err_callback_lent      = false;
+
+  //! register right away so that registration errors (such as FD_SETSIZE being exceeded) are reported to the caller
+  update_polled_events(fd, track_info);
+
+  wake_up();
+}
 
-  auto& track_info                    = m_tracked_sockets[socket.get_fd()];
-  track_info.rd_callback              = rd_callback;
-  track_info.wr_callback              = wr_callback;
-  track_info.marked_for_untrack       = false;
-  track_info.is_executing_rd_callback = false;
-  track_info.is_executing_wr_callback = false;
-
-  m_notifier.notify();
+void
+io_service::track(const tcp_socket& socket, event_callback_t rd_callback, event_callback_t wr_callback, event_callback_t err_callback) {
+  set_socket_busy_poll(socket.get_fd());
+  track_fd(socket.get_fd(), std::move(rd_callback), std::move(wr_callback), std::move(err_callback));
 }
 
 void
-io_service::set_rd_callback(const tcp_socket& socket, const event_callback_t& event_callback) {
+io_service::set_fd_rd_callback(fd_t fd, event_callback_t event_callback) {
   std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
 
   __TACOPIE_LOG(debug, "update read socket tracking callback");
 
-  auto& track_info       = m_tracked_sockets[socket.get_fd()];
-  track_info.rd_callback = event_callback;
+  //! a callback being executed is replaced: it must not be given back once completed
+  auto& track_info               = get_tracked_socket(fd);
+  track_info.rd_callback         = std::move(event_callback);
+  track_info.is_rd_callback_lent = false;
 
-  m_notifier.notify();
+  queue_polled_events_update(fd, track_info);
 }
 
 void
-io_service::set_wr_callback(const tcp_socket& socket, const event_callback_t& event_callback) {
+io_service::set_rd_callback(const tcp_socket& socket, event_callback_t event_callback) {
+  set_fd_rd_callback(socket.get_fd(), std::move(event_callback));
+}
+
+void
+io_service::set_fd_wr_callback(fd_t fd, event_callback_t event_callback) {
   std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
 
   __TACOPIE_LOG(debug, "update write socket tracking callback");
 
-  auto& track_info       = m_tracked_sockets[socket.get_fd()];
-  track_info.wr_callback = event_callback;
+  //! a callback being executed is replaced: it must not be given back once completed
+  auto& track_info               = get_tracked_socket(fd);
+  track_info.wr_callback         = std::move(event_callback);
+  track_info.is_wr_callback_lent = false;
 
-  m_notifier.notify();
+  queue_polled_events_update(fd, track_info);
 }
 
 void
-io_service::untrack(const tcp_socket& socket) {
+io_service::set_wr_callback(const tcp_socket& socket, event_callback_t event_callback) {
+  set_fd_wr_callback(socket.get_fd(), std::move(event_callback));
+}
+
+void
+io_service::set_fd_err_callback(fd_t fd, event_callback_t event_callback) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  __TACOPIE_LOG(debug, "update error socket tracking callback");
+
+  //! a callback being executed is replaced: it must not be given back once completed
+  auto& track_info                = get_tracked_socket(fd);
+  track_info.err_callback         = std::move(event_callback);
+  track_info.is_err_callback_lent = false;
+
+  queue_polled_events_update(fd, track_info);
+}
+
+void
+io_service::set_err_callback(const tcp_socket& socket, event_callback_t event_callback) {
+  set_fd_err_callback(socket.get_fd(), std::move(event_callback));
+}
+
+void
+io_service::untrack_fd(fd_t fd) {
   std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
 
-  auto it = m_tracked_sockets.find(socket.get_fd());
+  auto socket_ptr = m_tracked_sockets.find(fd);
+
+  if (!socket_ptr) { return; }
 
-  if (it == m_tracked_sockets.end()) { return; }
+  __TACOPIE_RECORD(untrack, fd, 0);
 
-  if (it->second.is_executing_rd_callback || it->second.is_executing_wr_callback) {
+  //! unregister right away (instead of queuing an update): the socket is likely to be closed as soon as this function returns
+  if (socket_ptr->is_registered) {
+    m_poller->remove(fd);
+    socket_ptr->is_registered = false;
+  }
+
+  if (socket_ptr->is_executing_callback()) {
     __TACOPIE_LOG(debug, "mark socket for untracking");
-    it->second.marked_for_untrack = true;
+    socket_ptr->marked_for_untrack = true;
   }
   else {
     __TACOPIE_LOG(debug, "untrack socket");
-    m_tracked_sockets.erase(it);
-    m_wait_for_removal_condvar.notify_all();
+    erase_tracked_socket(fd);
   }
+}
 
-  m_notifier.notify();
+void
+io_service::untrack(const tcp_socket& socket) {
+  untrack_fd(socket.get_fd());
+}
+
+//!
+//! completion-based operations
+//!
+
+bool
+io_service::supports_completions(void) const {
+  return m_poller->supports_completions();
+}
+
+void
+io_service::submit_recv(const tcp_socket& socket, std::size_t size) {
+  m_poller->submit_recv(socket.get_fd(), size);
+}
+
+void
+io_service::submit_send(const tcp_socket& socket, std::vector<char> buffer, std::uint64_t token) {
+  m_poller->submit_send(socket.get_fd(), std::move(buffer), token);
+}
+
+void
+io_service::submit_accept(const tcp_socket& socket) {
+  m_poller->submit_accept(socket.get_fd());
+}
+
+bool
+io_service::take_rd_completion(const tcp_socket& socket, std::size_t max_size, completion& result) {
+  return m_poller->take_completion(socket.get_fd(), poller_iface::rd_event, max_size, result);
+}
+
+bool
+io_service::take_wr_completion(const tcp_socket& socket, completion& result) {
+  return m_poller->take_completion(socket.get_fd(), poller_iface::wr_event, 0, result);
 }
 
 //!
@@ -333,17 +1181,45 @@ io_service::untrack(const tcp_socket& socket) {
 //! basically wait until all pending callbacks are executed
 //!
 
+void
+io_service::wait_for_fd_removal(fd_t fd) {
+  __TACOPIE_LOG(debug, "waiting for socket removal");
+
+  get_fd_removal_future(fd).wait();
+
+  __TACOPIE_LOG(debug, "socket has been removed");
+}
+
 void
 io_service::wait_for_removal(const tcp_socket& socket) {
-  std::unique_lock<std::mutex> lock(m_tracked_sockets_mtx);
+  wait_for_fd_removal(socket.get_fd());
+}
 
-  __TACOPIE_LOG(debug, "waiting for socket removal");
+std::shared_future<void>
+io_service::get_fd_removal_future(fd_t fd) {
+  std::lock_guard<std::mutex> lock(m_tracked_sockets_mtx);
+
+  auto socket_ptr = m_tracked_sockets.find(fd);
 
-  m_wait_for_removal_condvar.wait(lock, [&]() {
-    __TACOPIE_LOG(debug, "socket has been removed");
+  if (!socket_ptr) {
+    std::promise<void> removed;
+    removed.set_value();
+
+    return removed.get_future().share();
+  }
+
+  //! the promise is only allocated for sockets that are actually waited for
+  if (!socket_ptr->removal) {
+    socket_ptr->removal.reset(new std::promise<void>);
+    socket_ptr->removal_future = socket_ptr->removal->get_future().share();
+  }
+
+  return socket_ptr->removal_future;
+}
 
-    return m_tracked_sockets.find(socket.get_fd()) == m_tracked_sockets.end();
-  });
+std::shared_future<void>
+io_service::get_removal_future(const tcp_socket& socket) {
+  return get_fd_removal_future(socket.get_fd());
 }
 
 } // namespace tacopie
@@ -0,0 +1,202 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/network/io_service_group.hpp>
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+#include <tacopie/utils/thread_config.hpp>
+
+#include <algorithm>
+#include <string>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif /* __linux__ */
+
+namespace tacopie {
+
+//!
+//! ctor
+//!
+
+io_service_group::io_service_group(std::size_t nb_services, assignment_policy policy, bool pin_poll_threads)
+: io_service_group(nb_services, policy, pin_poll_threads, poller_type::__TACOPIE_DEFAULT_POLLER) {}
+
+io_service_group::io_service_group(std::size_t nb_services, assignment_policy policy, bool pin_poll_threads, poller_type type)
+: m_next_io_service(0) {
+  __TACOPIE_LOG(debug, "create io_service_group");
+
+  //! only the cpus the process is allowed to run on (taskset, cpusets): pinning to any other one fails
+  std::vector<std::size_t> cpus = utils::get_allowed_cpus();
+  if (!nb_services) { nb_services = cpus.size(); }
+
+  for (std::size_t i = 0; i < nb_services; ++i) {
+    auto service = std::make_shared<io_service>(type);
+    int numa_node = -1;
+
+    //! shorter names, as they are truncated to 15 characters on linux
+    service->set_poll_thread_name("tacopie-poll-" + std::to_string(i));
+    service->set_workers_name("tacopie-w" + std::to_string(i));
+
+    if (pin_poll_threads) {
+      std::size_t cpu = cpus[i % cpus.size()];
+
+      //! pinning is an optimization: the group is usable without it
+      try {
+        service->set_poll_thread_affinity({cpu});
+
+        //! keep the callbacks on the memory node of the poll thread
+        numa_node = utils::get_numa_node(cpu);
+        auto node_cpus = utils::get_numa_node_cpus(numa_node);
+        node_cpus.erase(std::remove_if(node_cpus.begin(), node_cpus.end(), [&](std::size_t node_cpu) { return std::find(cpus.begin(), cpus.end(), node_cpu) == cpus.end(); }), node_cpus.end());
+        if (!node_cpus.empty()) { service->set_workers_affinity({node_cpus}); }
+      }
+      catch (const tacopie_error&) {
+        __TACOPIE_LOG(warn, "could not pin the poll thread of io_service " + std::to_string(i) + " to cpu " + std::to_string(cpu));
+      }
+    }
+
+    m_io_services.push_back(service);
+    m_io_services_numa_nodes.push_back(numa_node);
+  }
+
+  set_assignment_policy(policy);
+}
+
+//!
+//! assignment policies
+//!
+
+std::size_t
+io_service_group::least_loaded_io_service(const std::vector<std::shared_ptr<io_service>>& services, const std::function<bool(std::size_t)>& filter) {
+  std::size_t index  = services.size();
+  std::size_t lowest = 0;
+
+  for (std::size_t i = 0; i < services.size(); ++i) {
+    if (!filter(i)) { continue; }
+
+    std::size_t load = services[i]->get_nb_tracked_sockets();
+    if (index == services.size() || load < lowest) {
+      index  = i;
+      lowest = load;
+    }
+
+    if (!lowest) { break; }
+  }
+
+  return index;
+}
+
+//!
+//! cpu that processed the last packets received by the socket (the one servicing its NIC queue), -1 if unknown
+//!
+static int
+get_incoming_cpu(fd_t fd) {
+#ifdef SO_INCOMING_CPU
+  int cpu       = -1;
+  socklen_t len = sizeof(cpu);
+
+  if (getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) < 0) { return -1; }
+
+  return cpu;
+#else
+  (void) fd;
+  return -1;
+#endif /* SO_INCOMING_CPU */
+}
+
+void
+io_service_group::set_assignment_policy(assignment_policy policy) {
+  switch (policy) {
+  case assignment_policy::least_loaded:
+    set_assignment_policy([](fd_t, const std::vector<std::shared_ptr<io_service>>& services) {
+      return least_loaded_io_service(services, [](std::size_t) { return true; });
+    });
+    break;
+
+  case assignment_policy::numa_local:
+    set_assignment_policy([this](fd_t fd, const std::vector<std::shared_ptr<io_service>>& services) {
+      int cpu       = get_incoming_cpu(fd);
+      int numa_node = cpu < 0 ? -1 : utils::get_numa_node(cpu);
+
+      if (numa_node >= 0) {
+        std::size_t index = least_loaded_io_service(services, [&](std::size_t i) { return i < m_io_services_numa_nodes.size() && m_io_services_numa_nodes[i] == numa_node; });
+        if (index < services.size()) { return index; }
+      }
+
+      return least_loaded_io_service(services, [](std::size_t) { return true; });
+    });
+    break;
+
+  case assignment_policy::hash:
+    set_assignment_policy([](fd_t fd, const std::vector<std::shared_ptr<io_service>>& services) {
+      return std::hash<fd_t>()(fd) % services.size();
+    });
+    break;
+
+  case assignment_policy::round_robin:
+  default:
+    set_assignment_policy([this](fd_t, const std::vector<std::shared_ptr<io_service>>& services) {
+      return m_next_io_service++ % services.size();
+    });
+    break;
+  }
+}
+
+void
+io_service_group::set_assignment_policy(const assignment_policy_t& policy) {
+  std::lock_guard<std::mutex> lock(m_policy_mtx);
+
+  m_policy = policy;
+}
+
+//!
+//! io_services getters
+//!
+
+const std::shared_ptr<io_service>&
+io_service_group::get_io_service(const tcp_socket& socket) {
+  std::size_t index;
+
+  {
+    std::lock_guard<std::mutex> lock(m_policy_mtx);
+
+    index = m_policy(socket.get_fd(), m_io_services);
+  }
+
+  if (index >= m_io_services.size()) { __TACOPIE_THROW(error, "assignment policy returned an invalid io_service index"); }
+
+  return m_io_services[index];
+}
+
+const std::vector<std::shared_ptr<io_service>>&
+io_service_group::get_io_services(void) const {
+  return m_io_services;
+}
+
+const std::vector<int>&
+io_service_group::get_io_services_numa_nodes(void) const {
+  return m_io_services_numa_nodes;
+}
+
+} // namespace tacopie
@@ -24,6 +24,8 @@
 #include <tacopie/utils/error.hpp>
 #include <tacopie/utils/logger.hpp>
 
+#include <algorithm>
+
 namespace tacopie {
 
 //!
@@ -39,6 +41,11 @@ tcp_client::tcp_client(void)
 tcp_client::~tcp_client(void) {
   __TACOPIE_LOG(debug, "destroy tcp_client");
   disconnect(true);
+
+  //! pending deadline timers have been cancelled by disconnect, wait for the ones being executed (user code excluded, see timeout_notification)
+  std::unique_lock<std::mutex> lock(m_timers_state->mtx);
+  m_timers_state->client = nullptr;
+  m_timers_state->executing_condvar.wait(lock, [&] { return !m_timers_state->nb_executing; });
 }
 
 //!
@@ -47,12 +54,28 @@ tcp_client::~tcp_client(void) {
 //!
 
 tcp_client::tcp_client(tcp_socket&& socket)
-: m_io_service(get_default_io_service())
+: tcp_client(std::move(socket), get_default_io_service()) {}
+
+tcp_client::tcp_client(tcp_socket&& socket, const std::shared_ptr<io_service>& service)
+: m_io_service(service)
 , m_socket(std::move(socket))
 , m_disconnection_handler(nullptr) {
   m_is_connected = true;
   __TACOPIE_LOG(debug, "create tcp_client");
-  m_io_service->track(m_socket);
+  m_io_service->track(m_socket, nullptr, nullptr, std::bind(&tcp_client::on_error, this, std::placeholders::_1));
+  m_use_completions = m_io_service->supports_completions();
+}
+
+//!
+//! custom ctor
+//! io_service assigned from a group on connection
+//!
+
+tcp_client::tcp_client(const std::shared_ptr<io_service_group>& group)
+: m_io_service(group->get_io_services().front())
+, m_io_service_group(group)
+, m_disconnection_handler(nullptr) {
+  __TACOPIE_LOG(debug, "create tcp_client");
 }
 
 //!
@@ -79,7 +102,12 @@ tcp_client::connect(const std::string& host, std::uint32_t port, std::uint32_t t
 
   try {
     m_socket.connect(host, port, timeout_msecs);
-    m_io_service->track(m_socket);
+
+    if (m_io_service_group) { m_io_service = m_io_service_group->get_io_service(m_socket); }
+    m_io_service->track(m_socket, nullptr, nullptr, std::bind(&tcp_client::on_error, this, std::placeholders::_1));
+    m_use_completions = m_io_service->supports_completions();
+    if (m_strand) { m_io_service->set_strand(m_socket, m_strand); }
+    if (m_priority != io_service::priority::normal) { m_io_service->set_priority(m_socket, m_priority); }
   }
   catch (const tacopie_error& e) {
     m_socket.close();
@@ -119,16 +147,25 @@ void
 tcp_client::clear_read_requests(void) {
   std::lock_guard<std::mutex> lock(m_read_requests_mtx);
 
-  std::queue<read_request> empty;
-  std::swap(m_read_requests, empty);
+  for (const auto& pending : m_read_requests) {
+    if (pending.timer_id) { m_io_service->cancel(pending.timer_id); }
+  }
+
+  m_read_requests.clear();
 }
 
 void
 tcp_client::clear_write_requests(void) {
   std::lock_guard<std::mutex> lock(m_write_requests_mtx);
 
-  std::queue<write_request> empty;
-  std::swap(m_write_requests, empty);
+  for (const auto& pending : m_write_requests) {
+    if (pending.timer_id) { m_io_service->cancel(pending.timer_id); }
+  }
+
+  m_write_requests.clear();
+
+  //! the send in progress (if any) is cancelled when the socket is untracked
+  m_is_send_in_progress = false;
 }
 
 //!
@@ -183,6 +220,168 @@ tcp_client::on_write_available(fd_t) {
   if (!result.success) { call_disconnection_handler(); }
 }
 
+//!
+//! io service error callback
+//!
+
+void
+tcp_client::on_error(fd_t) {
+  //! disconnected in the meantime
+  if (!is_connected()) { return; }
+
+  //! a pending read (submitted as a completion) reports the EOF or the failure by itself, after the data it already received
+  {
+    std::lock_guard<std::mutex> lock(m_read_requests_mtx);
+
+    if (!m_read_requests.empty()) { return; }
+  }
+
+  bool is_closed;
+  try {
+    is_closed = m_socket.is_remotely_closed();
+  }
+  catch (const tacopie_error&) {
+    is_closed = true;
+  }
+
+  if (!is_closed) {
+    //! the peer shut its side down, but data is still buffered: the next reads deliver it, then fail on EOF
+    //! hangups are level triggered, so stop watching for them in the meantime
+    __TACOPIE_LOG(info, "peer closed its side of the connection, data left to read");
+    m_io_service->set_err_callback(m_socket, nullptr);
+    return;
+  }
+
+  __TACOPIE_LOG(warn, "connection error or hangup");
+  disconnect();
+
+  call_disconnection_handler();
+}
+
+//!
+//! deadline timers callbacks
+//!
+
+void
+tcp_client::timeout_notification::operator()(void) {
+  if (read_callback) {
+    read_result result;
+    result.success   = false;
+    result.timed_out = true;
+    read_callback(result);
+  }
+
+  if (write_callback) {
+    write_result result;
+    result.success   = false;
+    result.size      = 0;
+    result.timed_out = true;
+    write_callback(result);
+  }
+
+  if (disconnection_handler) { disconnection_handler(); }
+}
+
+tcp_client::timeout_notification
+tcp_client::on_read_timeout(std::uint64_t id) {
+  timeout_notification notification;
+  bool disconnect_on_timeout;
+
+  {
+    std::lock_guard<std::mutex> lock(m_read_requests_mtx);
+
+    auto it = std::find_if(m_read_requests.begin(), m_read_requests.end(), [&](const pending_read_request& pending) { return pending.id == id; });
+
+    //! the request completed in the meantime
+    if (it == m_read_requests.end()) { return notification; }
+
+    notification.read_callback = std::move(it->request.async_read_callback);
+    disconnect_on_timeout      = it->request.disconnect_on_timeout;
+    m_read_requests.erase(it);
+
+    if (m_read_requests.empty()) { m_io_service->set_rd_callback(m_socket, nullptr); }
+  }
+
+  __TACOPIE_LOG(warn, "read operation timeout");
+
+  if (disconnect_on_timeout) {
+    disconnect();
+    notification.disconnection_handler = m_disconnection_handler;
+  }
+
+  return notification;
+}
+
+tcp_client::timeout_notification
+tcp_client::on_write_timeout(std::uint64_t id) {
+  timeout_notification notification;
+  bool disconnect_on_timeout;
+
+  {
+    std::lock_guard<std::mutex> lock(m_write_requests_mtx);
+
+    auto it = std::find_if(m_write_requests.begin(), m_write_requests.end(), [&](const pending_write_request& pending) { return pending.id == id; });
+
+    //! the request completed in the meantime
+    if (it == m_write_requests.end()) { return notification; }
+
+    notification.write_callback = std::move(it->request.async_write_callback);
+    disconnect_on_timeout       = it->request.disconnect_on_timeout;
+    m_write_requests.erase(it);
+
+    if (m_write_requests.empty()) { m_io_service->set_wr_callback(m_socket, nullptr); }
+  }
+
+  __TACOPIE_LOG(warn, "write operation timeout");
+
+  if (disconnect_on_timeout) {
+    disconnect();
+    notification.disconnection_handler = m_disconnection_handler;
+  }
+
+  return notification;
+}
+
+io_service::timer_id_t
+tcp_client::schedule_request_timeout(std::uint32_t timeout_msecs, timeout_notification (tcp_client::*on_timeout)(std::uint64_t), std::uint64_t id) {
+  std::shared_ptr<timers_state> state = m_timers_state;
+  auto strand                         = m_strand;
+
+  return m_io_service->schedule_after(timeout_msecs, [=] {
+    auto callback = [=] {
+      tcp_client* client;
+
+      {
+        std::lock_guard<std::mutex> lock(state->mtx);
+
+        client = state->client;
+        if (!client) { return; }
+
+        ++state->nb_executing;
+      }
+
+      timeout_notification notification = (client->*on_timeout)(id);
+
+      {
+        std::lock_guard<std::mutex> lock(state->mtx);
+
+        if (!--state->nb_executing) { state->executing_condvar.notify_all(); }
+      }
+
+      //! no longer calling into the client: it may be destroyed from its own callbacks
+      notification();
+    };
+
+    //! serialized with the read and write callbacks of the client
+    if (strand) {
+      *strand << callback;
+    }
+    else {
+      callback();
+    }
+  });
+}
+
 //!
 //! process read & write operations when available
 //!
@@ -191,22 +390,45 @@ tcp_client::async_read_callback_t
 tcp_client::process_read(read_result& result) {
   std::lock_guard<std::mutex> lock(m_read_requests_mtx);
 
+  result.success   = true;
+  result.timed_out = false;
+
   if (m_read_requests.empty()) { return nullptr; }
 
-  const auto& request = m_read_requests.front();
-  auto callback       = request.async_read_callback;
+  auto& pending = m_read_requests.front();
+  auto& request = pending.request;
 
   try {
-    result.buffer  = m_socket.recv(request.size);
-    result.success = true;
+    if (m_use_completions) {
+      io_service::completion completion;
+
+      //! the recv is still in progress
+      if (!m_io_service->take_rd_completion(m_socket, request.size, completion)) { return nullptr; }
+
+      //! 0 if the connection has been closed by remote host
+      result.success = completion.result > 0;
+      result.buffer  = std::move(completion.buffer);
+    }
+    else {
+      result.buffer = m_socket.recv(request.size);
+    }
   }
   catch (const tacopie::tacopie_error&) {
     result.success = false;
   }
 
-  m_read_requests.pop();
+  auto callback = std::move(request.async_read_callback);
 
-  if (m_read_requests.empty()) { m_io_service->set_rd_callback(m_socket, nullptr); }
+  if (pending.timer_id) { m_io_service->cancel(pending.timer_id); }
+
+  m_read_requests.pop_front();
+
+  if (m_read_requests.empty()) {
+    m_io_service->set_rd_callback(m_socket, nullptr);
+  }
+  else if (m_use_completions && result.success) {
+    m_io_service->submit_recv(m_socket, m_read_requests.front().request.size);
+  }
 
   return callback;
 }
@@ -215,37 +437,82 @@ tcp_client::async_write_callback_t
 tcp_client::process_write(write_result& result) {
   std::lock_guard<std::mutex> lock(m_write_requests_mtx);
 
+  result.success   = true;
+  result.size      = 0;
+  result.timed_out = false;
+
   if (m_write_requests.empty()) { return nullptr; }
 
-  const auto& request = m_write_requests.front();
-  auto callback       = request.async_write_callback;
+  auto& pending = m_write_requests.front();
+  auto& request = pending.request;
 
   try {
-    result.size    = m_socket.send(request.buffer, request.buffer.size());
-    result.success = true;
+    if (m_use_completions) {
+      io_service::completion completion;
+
+      //! the send is still in progress
+      if (!m_io_service->take_wr_completion(m_socket, completion)) { return nullptr; }
+
+      m_is_send_in_progress = false;
+
+      //! completion of a request that timed out in the meantime (its callback has already been called): send the next one
+      if (completion.token != pending.id) {
+        submit_send(pending);
+        return nullptr;
+      }
+
+      result.success = completion.result >= 0;
+      if (result.success) { result.size = static_cast<std::size_t>(completion.result); }
+    }
+    else {
+      result.size = m_socket.send(request.buffer, request.buffer.size());
+    }
   }
   catch (const tacopie::tacopie_error&) {
     result.success = false;
   }
 
-  m_write_requests.pop();
+  auto callback = std::move(request.async_write_callback);
+
+  if (pending.timer_id) { m_io_service->cancel(pending.timer_id); }
 
-  if (m_write_requests.empty()) { m_io_service->set_wr_callback(m_socket, nullptr); }
+  m_write_requests.pop_front();
+
+  if (m_write_requests.empty()) {
+    m_io_service->set_wr_callback(m_socket, nullptr);
+  }
+  else if (m_use_completions && result.success) {
+    submit_send(m_write_requests.front());
+  }
 
   return callback;
 }
 
+void
+tcp_client::submit_send(pending_write_request& pending) {
+  m_io_service->submit_send(m_socket, std::move(pending.request.buffer), pending.id);
+  m_is_send_in_progress = true;
+}
+
 //!
 //! async read & write operations
 //!
 
 void
-tcp_client::async_read(const read_request& request) {
+tcp_client::async_read(read_request request) {
   std::lock_guard<std::mutex> lock(m_read_requests_mtx);
 
   if (is_connected()) {
+    //! the recv of the following requests is submitted once the current one completes
+    if (m_use_completions && m_read_requests.empty()) { m_io_service->submit_recv(m_socket, request.size); }
+
     m_io_service->set_rd_callback(m_socket, std::bind(&tcp_client::on_read_available, this, std::placeholders::_1));
-    m_read_requests.push(request);
+
+    std::uint64_t id                = m_next_request_id++;
+    io_service::timer_id_t timer_id = 0;
+    if (request.timeout_msecs) { timer_id = schedule_request_timeout(request.timeout_msecs, &tcp_client::on_read_timeout, id); }
+
+    m_read_requests.push_back({std::move(request), id, timer_id});
   }
   else {
     __TACOPIE_THROW(warn, "tcp_client is disconnected");
@@ -253,12 +520,20 @@ tcp_client::async_read(const read_request& request) {
 }
 
 void
-tcp_client::async_write(const write_request& request) {
+tcp_client::async_write(write_request request) {
   std::lock_guard<std::mutex> lock(m_write_requests_mtx);
 
   if (is_connected()) {
     m_io_service->set_wr_callback(m_socket, std::bind(&tcp_client::on_write_available, this, std::placeholders::_1));
-    m_write_requests.push(request);
+
+    std::uint64_t id                = m_next_request_id++;
+    io_service::timer_id_t timer_id = 0;
+    if (request.timeout_msecs) { timer_id = schedule_request_timeout(request.timeout_msecs, &tcp_client::on_write_timeout, id); }
+
+    m_write_requests.push_back({std::move(request), id, timer_id});
+
+    //! the following requests are sent once the send in progress completes
+    if (m_use_completions && !m_is_send_in_progress) { submit_send(m_write_requests.back()); }
   }
   else {
     __TACOPIE_THROW(warn, "tcp_client is disconnected");
@@ -287,6 +562,38 @@ tcp_client::get_io_service(void) const {
   return m_io_service;
 }
 
+//!
+//! strand
+//!
+
+void
+tcp_client::set_strand(const std::shared_ptr<utils::strand>& strand) {
+  m_strand = strand;
+
+  if (is_connected()) { m_io_service->set_strand(m_socket, m_strand); }
+}
+
+const std::shared_ptr<utils::strand>&
+tcp_client::get_strand(void) const {
+  return m_strand;
+}
+
+//!
+//! priority
+//!
+
+void
+tcp_client::set_priority(io_service::priority client_priority) {
+  m_priority = client_priority;
+
+  if (is_connected()) { m_io_service->set_priority(m_socket, m_priority); }
+}
+
+io_service::priority
+tcp_client::get_priority(void) const {
+  return m_priority;
+}
+
 //!
 //! set on disconnection handler
 //!
@@ -36,6 +36,11 @@ tcp_server::tcp_server(void)
 : m_io_service(get_default_io_service())
 , m_on_new_connection_callback(nullptr) { __TACOPIE_LOG(debug, "create tcp_server"); }
 
+tcp_server::tcp_server(const std::shared_ptr<io_service_group>& group)
+: m_io_service(group->get_io_services().front())
+, m_io_service_group(group)
+, m_on_new_connection_callback(nullptr) { __TACOPIE_LOG(debug, "create tcp_server"); }
+
 tcp_server::~tcp_server(void) {
   __TACOPIE_LOG(debug, "destroy tcp_server");
   stop();
@@ -52,7 +57,10 @@ tcp_server::start(const std::string& host, std::uint32_t port, const on_new_conn
   m_socket.bind(host, port);
   m_socket.listen(__TACOPIE_CONNECTION_QUEUE_SIZE);
 
+  if (m_io_service_group) { m_io_service = m_io_service_group->get_io_service(m_socket); }
   m_io_service->track(m_socket);
+  m_use_completions = m_io_service->supports_completions();
+  if (m_use_completions) { m_io_service->submit_accept(m_socket); }
   m_io_service->set_rd_callback(m_socket, std::bind(&tcp_server::on_read_available, this, std::placeholders::_1));
   m_on_new_connection_callback = callback;
 
@@ -87,9 +95,20 @@ tcp_server::stop(bool wait_for_removal, bool recursive_wait_for_removal) {
 void
 tcp_server::on_read_available(fd_t) {
   try {
+    io_service::completion completion;
+
+    //! the accept is still in progress
+    if (m_use_completions && !m_io_service->take_rd_completion(m_socket, 0, completion)) { return; }
+
     __TACOPIE_LOG(info, "tcp_server received new connection");
 
-    auto client = std::make_shared<tcp_client>(m_socket.accept());
+    auto socket = m_use_completions ? m_socket.accept(completion) : m_socket.accept();
+
+    //! accept the next connection
+    if (m_use_completions) { m_io_service->submit_accept(m_socket); }
+
+    auto service = m_io_service_group ? m_io_service_group->get_io_service(socket) : get_default_io_service();
+    auto client  = std::make_shared<tcp_client>(std::move(socket), service);
 
     if (!m_on_new_connection_callback || !m_on_new_connection_callback(client)) {
       __TACOPIE_LOG(info, "connection handling delegated to tcp_server");
@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+//! guard for bulk content integration depending on how user integrates the library
+#ifdef __linux__
+
+#include <tacopie/network/epoll_poller.hpp>
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+
+#include <cerrno>
+
+#include <unistd.h>
+
+#ifndef __TACOPIE_EPOLL_INITIAL_NB_EVENTS
+#define __TACOPIE_EPOLL_INITIAL_NB_EVENTS 64
+#endif /* __TACOPIE_EPOLL_INITIAL_NB_EVENTS */
+
+namespace tacopie {
+
+//!
+//! convert event_type flags into epoll flags
+//!
+static std::uint32_t
+to_epoll_events(int events) {
+  std::uint32_t epoll_events = 0;
+
+  if (events & poller_iface::rd_event) { epoll_events |= EPOLLIN; }
+  if (events & poller_iface::wr_event) { epoll_events |= EPOLLOUT; }
+
+  //! EPOLLERR and EPOLLHUP are always reported (as long as the fd is armed), EPOLLRDHUP notices the peer closing an idle connection
+  if (events & poller_iface::err_event) { epoll_events |= EPOLLRDHUP; }
+
+  return epoll_events;
+}
+
+//!
+//! ctor & dtor
+//!
+
+epoll_poller::epoll_poller(void)
+: m_epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+, m_epoll_events(__TACOPIE_EPOLL_INITIAL_NB_EVENTS) {
+  __TACOPIE_LOG(debug, "create epoll_poller");
+
+  if (m_epoll_fd == __TACOPIE_INVALID_FD) { __TACOPIE_THROW(error, "epoll_create1() failure"); }
+}
+
+epoll_poller::~epoll_poller(void) {
+  if (m_epoll_fd != __TACOPIE_INVALID_FD) {
+    close(m_epoll_fd);
+  }
+}
+
+//!
+//! register, update & unregister fds
+//!
+
+void
+epoll_poller::add(fd_t fd, int events, bool persistent) {
+  struct epoll_event ev;
+  ev.events  = to_epoll_events(events) | (persistent ? 0 : static_cast<std::uint32_t>(EPOLLONESHOT));
+  ev.data.fd = fd;
+
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) { return; }
+
+  //! fd may have been closed and reused without being removed first
+  if (errno != EEXIST || epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+    __TACOPIE_THROW(error, "epoll_ctl() failure");
+  }
+}
+
+void
+epoll_poller::modify(fd_t fd, int events) {
+  struct epoll_event ev;
+  ev.events  = to_epoll_events(events) | EPOLLONESHOT;
+  ev.data.fd = fd;
+
+  //! fd closed in the meantime (and automatically unregistered by the kernel): register it again
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1 && errno == ENOENT) {
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+  }
+}
+
+void
+epoll_poller::remove(fd_t fd) {
+  //! failure means the fd has already been closed, and thus unregistered by the kernel
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+//!
+//! wait for events
+//!
+
+void
+epoll_poller::wait(std::vector<event>& events, int timeout_msecs) {
+  events.clear();
+
+  int nb_events = epoll_wait(m_epoll_fd, m_epoll_events.data(), (int) m_epoll_events.size(), timeout_msecs);
+
+  for (int i = 0; i < nb_events; ++i) {
+    const auto& ev = m_epoll_events[i];
+    int reported   = poller_iface::no_event;
+
+    if (ev.events & EPOLLIN) { reported |= poller_iface::rd_event; }
+    if (ev.events & EPOLLOUT) { reported |= poller_iface::wr_event; }
+
+    //! errors and hangups are reported as read & write availability too: the subsequent recv/send reports the failure
+    if (ev.events & (EPOLLERR | EPOLLHUP)) { reported |= poller_iface::rd_event | poller_iface::wr_event | poller_iface::err_event; }
+    if (ev.events & EPOLLRDHUP) { reported |= poller_iface::hup_event; }
+
+    events.push_back({ev.data.fd, reported});
+  }
+
+  //! buffer was too small to retrieve all the ready fds at once, grow it for next time
+  if (nb_events == (int) m_epoll_events.size()) {
+    m_epoll_events.resize(m_epoll_events.size() * 2);
+  }
+}
+
+poller_type
+epoll_poller::get_type(void) const {
+  return poller_type::epoll;
+}
+
+} // namespace tacopie
+
+#endif /* __linux__ */
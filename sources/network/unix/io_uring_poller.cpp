@@ -0,0 +1,647 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/network/io_uring_poller.hpp>
+
+//! guard for bulk content integration depending on how user integrates the library
+#ifdef __TACOPIE_HAS_IO_URING
+
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tacopie {
+
+//!
+//! user_data of the requests whose completion is ignored (poll removals, cancellations & timeouts)
+//! poll and operation requests user_data always have a non-zero sequence number in their upper bits
+//!
+static const std::uint64_t ignored_user_data = 0;
+
+//!
+//! convert event_type flags into poll flags
+//!
+static unsigned int
+to_poll_events(int events) {
+  unsigned int poll_events = 0;
+
+  if (events & poller_iface::rd_event) { poll_events |= POLLIN; }
+  if (events & poller_iface::wr_event) { poll_events |= POLLOUT; }
+
+  //! POLLERR and POLLHUP are always reported, POLLRDHUP notices the peer closing an idle connection
+  if (events & poller_iface::err_event) { poll_events |= POLLRDHUP; }
+
+  return poll_events;
+}
+
+//!
+//! ctor & dtor
+//!
+
+io_uring_poller::io_uring_poller(unsigned int nb_entries)
+: m_ring_fd(__TACOPIE_INVALID_FD)
+, m_sq_ring(MAP_FAILED)
+, m_sq_ring_size(0)
+, m_cq_ring(MAP_FAILED)
+, m_cq_ring_size(0)
+, m_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED))
+, m_sqes_size(0)
+, m_supports_completions(false)
+, m_next_request_seq(1) {
+  __TACOPIE_LOG(debug, "create io_uring_poller");
+
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+
+  m_ring_fd = static_cast<fd_t>(syscall(__NR_io_uring_setup, nb_entries, &params));
+  if (m_ring_fd < 0) {
+    m_ring_fd = __TACOPIE_INVALID_FD;
+    __TACOPIE_THROW(error, "io_uring_setup() failure");
+  }
+
+  //! map the rings (a single mapping holds both rings on recent kernels)
+  m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  m_sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) { m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size); }
+
+  m_sq_ring = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    release();
+    __TACOPIE_THROW(error, "io_uring sq ring mmap() failure");
+  }
+
+  if (!single_mmap) {
+    m_cq_ring = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      release();
+      __TACOPIE_THROW(error, "io_uring cq ring mmap() failure");
+    }
+  }
+
+  m_sqes = static_cast<struct io_uring_sqe*>(mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES));
+  if (m_sqes == MAP_FAILED) {
+    release();
+    __TACOPIE_THROW(error, "io_uring sqes mmap() failure");
+  }
+
+  char* sq_ring = static_cast<char*>(m_sq_ring);
+  m_sq_head     = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.head);
+  m_sq_tail     = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.tail);
+  m_sq_mask     = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.ring_mask);
+  m_sq_array    = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.array);
+  m_sq_entries  = params.sq_entries;
+
+  char* cq_ring = static_cast<char*>(single_mmap ? m_sq_ring : m_cq_ring);
+  m_cq_head     = reinterpret_cast<unsigned int*>(cq_ring + params.cq_off.head);
+  m_cq_tail     = reinterpret_cast<unsigned int*>(cq_ring + params.cq_off.tail);
+  m_cq_mask     = reinterpret_cast<unsigned int*>(cq_ring + params.cq_off.ring_mask);
+  m_cqes        = reinterpret_cast<struct io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+
+  //! without fast poll, a recv waiting for data would hold a kernel worker thread
+  m_supports_completions = (params.features & IORING_FEAT_FAST_POLL) && probe_completions_support();
+
+  if (!m_supports_completions) { __TACOPIE_LOG(info, "io_uring completion-based operations are not supported by the kernel, using readiness only"); }
+}
+
+io_uring_poller::~io_uring_poller(void) {
+  cancel_all_operations();
+  release();
+}
+
+bool
+io_uring_poller::probe_completions_support(void) {
+  const unsigned int nb_ops = IORING_OP_LAST;
+
+  std::vector<char> probe_buffer(sizeof(struct io_uring_probe) + nb_ops * sizeof(struct io_uring_probe_op), 0);
+  auto probe = reinterpret_cast<struct io_uring_probe*>(probe_buffer.data());
+
+  if (syscall(__NR_io_uring_register, m_ring_fd, IORING_REGISTER_PROBE, probe, nb_ops) < 0) { return false; }
+
+  for (int opcode : {IORING_OP_RECV, IORING_OP_SEND, IORING_OP_ACCEPT, IORING_OP_ASYNC_CANCEL}) {
+    if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) { return false; }
+  }
+
+  return true;
+}
+
+void
+io_uring_poller::release(void) {
+  if (m_sqes != MAP_FAILED) { munmap(m_sqes, m_sqes_size); }
+  if (m_cq_ring != MAP_FAILED) { munmap(m_cq_ring, m_cq_ring_size); }
+  if (m_sq_ring != MAP_FAILED) { munmap(m_sq_ring, m_sq_ring_size); }
+  if (m_ring_fd != __TACOPIE_INVALID_FD) { close(m_ring_fd); }
+
+  m_sqes    = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+  m_cq_ring = MAP_FAILED;
+  m_sq_ring = MAP_FAILED;
+  m_ring_fd = __TACOPIE_INVALID_FD;
+}
+
+//!
+//! register, update & unregister fds
+//!
+
+void
+io_uring_poller::add(fd_t fd, int events, bool persistent) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  //! fd may have been closed and reused without being removed first
+  auto& reg = m_fds[fd];
+  disarm(reg);
+  cancel_operation(reg.rd_operation);
+  cancel_operation(reg.wr_operation);
+
+  reg.events            = events;
+  reg.persistent        = persistent;
+  reg.armed_completions = events & (rd_event | wr_event);
+  update(fd, reg);
+
+  submit_if_not_polling_thread();
+}
+
+void
+io_uring_poller::modify(fd_t fd, int events) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto it = m_fds.find(fd);
+  if (it == m_fds.end()) { return; }
+
+  auto& reg             = it->second;
+  reg.events            = events;
+  reg.armed_completions = events & (rd_event | wr_event);
+  update(fd, reg);
+
+  submit_if_not_polling_thread();
+}
+
+void
+io_uring_poller::remove(fd_t fd) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto it = m_fds.find(fd);
+  if (it == m_fds.end()) { return; }
+
+  //! the poll request and the operations hold a reference on the file: cancel them so that closing the fd effectively closes the socket
+  disarm(it->second);
+  cancel_operation(it->second.rd_operation);
+  cancel_operation(it->second.wr_operation);
+  m_fds.erase(it);
+
+  submit_if_not_polling_thread();
+}
+
+//!
+//! poll requests
+//!
+
+std::uint64_t
+io_uring_poller::get_next_request_id(fd_t fd) {
+  std::uint64_t id = (static_cast<std::uint64_t>(m_next_request_seq) << 32) | static_cast<std::uint32_t>(fd);
+  if (++m_next_request_seq == 0) { m_next_request_seq = 1; }
+
+  return id;
+}
+
+bool
+io_uring_poller::is_operation_pending(const std::unique_ptr<operation>& op) {
+  return op && (op->id || op->is_completed);
+}
+
+void
+io_uring_poller::update(fd_t fd, registration& reg) {
+  int poll_events = reg.events;
+  if (is_operation_pending(reg.rd_operation)) { poll_events &= ~rd_event; }
+  if (is_operation_pending(reg.wr_operation)) { poll_events &= ~wr_event; }
+
+  if (!reg.poll_id || reg.poll_events != poll_events) {
+    disarm(reg);
+    reg.poll_events = poll_events;
+    if (poll_events != no_event) { arm(fd, reg); }
+  }
+
+  //! completed operations are reported by the next wait, as readiness would be
+  if ((reg.armed_completions & rd_event) && reg.rd_operation && reg.rd_operation->is_completed) {
+    reg.armed_completions &= ~rd_event;
+    m_completions_to_report.push_back({fd, rd_event});
+  }
+
+  if ((reg.armed_completions & wr_event) && reg.wr_operation && reg.wr_operation->is_completed) {
+    reg.armed_completions &= ~wr_event;
+    m_completions_to_report.push_back({fd, wr_event});
+  }
+}
+
+void
+io_uring_poller::arm(fd_t fd, registration& reg) {
+  reg.poll_id = get_next_request_id(fd);
+
+  struct io_uring_sqe* sqe = get_sqe();
+  sqe->opcode              = IORING_OP_POLL_ADD;
+  sqe->fd                  = fd;
+  sqe->poll_events         = static_cast<__u16>(to_poll_events(reg.poll_events));
+  sqe->user_data           = reg.poll_id;
+  commit_sqe();
+}
+
+void
+io_uring_poller::disarm(registration& reg) {
+  if (!reg.poll_id) { return; }
+
+  struct io_uring_sqe* sqe = get_sqe();
+  sqe->opcode              = IORING_OP_POLL_REMOVE;
+  sqe->fd                  = -1;
+  sqe->addr                = reg.poll_id;
+  sqe->user_data           = ignored_user_data;
+  commit_sqe();
+
+  reg.poll_id = 0;
+}
+
+//!
+//! completion-based operations
+//!
+
+bool
+io_uring_poller::supports_completions(void) const {
+  return m_supports_completions;
+}
+
+io_uring_poller::registration&
+io_uring_poller::get_registration_for_operation(fd_t fd) {
+  if (!m_supports_completions) { __TACOPIE_THROW(error, "io_uring completion-based operations are not supported by the kernel"); }
+
+  auto it = m_fds.find(fd);
+  if (it == m_fds.end()) { __TACOPIE_THROW(error, "fd is not registered in the poller"); }
+
+  return it->second;
+}
+
+void
+io_uring_poller::submit_recv(fd_t fd, std::size_t size) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto& reg = get_registration_for_operation(fd);
+  if (!reg.rd_operation) { reg.rd_operation.reset(new operation()); }
+
+  auto& op = *reg.rd_operation;
+  if (op.id || op.is_completed) { return; }
+
+  op.opcode = IORING_OP_RECV;
+  op.buffer.resize(size);
+  submit_operation(fd, op);
+
+  submit_if_not_polling_thread();
+}
+
+void
+io_uring_poller::submit_send(fd_t fd, std::vector<char> buffer, std::uint64_t token) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto& reg = get_registration_for_operation(fd);
+  if (!reg.wr_operation) { reg.wr_operation.reset(new operation()); }
+
+  auto& op = *reg.wr_operation;
+  if (op.id || op.is_completed) { __TACOPIE_THROW(error, "a send is already in progress on this fd"); }
+
+  op.opcode = IORING_OP_SEND;
+  op.buffer = std::move(buffer);
+  op.token  = token;
+  submit_operation(fd, op);
+
+  submit_if_not_polling_thread();
+}
+
+void
+io_uring_poller::submit_accept(fd_t fd) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto& reg = get_registration_for_operation(fd);
+  if (!reg.rd_operation) { reg.rd_operation.reset(new operation()); }
+
+  auto& op = *reg.rd_operation;
+  if (op.id || op.is_completed) { return; }
+
+  op.opcode = IORING_OP_ACCEPT;
+  op.buffer.resize(sizeof(struct sockaddr_storage));
+  op.addr_len = sizeof(struct sockaddr_storage);
+  submit_operation(fd, op);
+
+  submit_if_not_polling_thread();
+}
+
+void
+io_uring_poller::submit_operation(fd_t fd, operation& op) {
+  op.id     = get_next_request_id(fd);
+  op.offset = 0;
+
+  struct io_uring_sqe* sqe = get_sqe();
+  sqe->opcode              = static_cast<__u8>(op.opcode);
+  sqe->fd                  = fd;
+  sqe->addr                = reinterpret_cast<std::uint64_t>(op.buffer.data());
+  sqe->user_data           = op.id;
+
+  if (op.opcode == IORING_OP_ACCEPT) {
+    sqe->addr2 = reinterpret_cast<std::uint64_t>(&op.addr_len);
+  }
+  else {
+    sqe->len = static_cast<__u32>(op.buffer.size());
+  }
+
+  commit_sqe();
+
+  //! readiness of the direction of the operation is no longer polled for
+  auto it = m_fds.find(fd);
+  if (it != m_fds.end() && it->second.poll_id) { update(fd, it->second); }
+}
+
+void
+io_uring_poller::cancel_operation(std::unique_ptr<operation>& op) {
+  if (!op || !op->id) { return; }
+
+  struct io_uring_sqe* sqe = get_sqe();
+  sqe->opcode              = IORING_OP_ASYNC_CANCEL;
+  sqe->fd                  = -1;
+  sqe->addr                = op->id;
+  sqe->user_data           = ignored_user_data;
+  commit_sqe();
+
+  //! the kernel may still write to the buffer until the completion of the operation is received
+  std::uint64_t id = op->id;
+  m_cancelled_operations[id] = std::move(op);
+}
+
+bool
+io_uring_poller::take_completion(fd_t fd, int event, std::size_t max_size, completion& result) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  auto& reg = get_registration_for_operation(fd);
+  auto& op  = event == rd_event ? reg.rd_operation : reg.wr_operation;
+
+  if (!op || !op->is_completed) { return false; }
+
+  result.result = op->result;
+  result.token  = op->token;
+  result.buffer.clear();
+
+  if (op->opcode == IORING_OP_RECV && op->result > 0) {
+    std::size_t nb_available = static_cast<std::size_t>(op->result) - op->offset;
+    std::size_t nb_taken     = std::min(nb_available, max_size);
+
+    if (op->offset == 0 && nb_taken == nb_available) {
+      op->buffer.resize(nb_taken);
+      std::swap(result.buffer, op->buffer);
+    }
+    else {
+      result.buffer.assign(op->buffer.begin() + op->offset, op->buffer.begin() + op->offset + nb_taken);
+    }
+
+    result.result = static_cast<int>(nb_taken);
+    op->offset += nb_taken;
+
+    //! remaining bytes are reported again once the fd is armed for read
+    if (op->offset < static_cast<std::size_t>(op->result)) { return true; }
+  }
+  else if (op->opcode == IORING_OP_ACCEPT && op->result >= 0) {
+    result.buffer.assign(op->buffer.begin(), op->buffer.begin() + std::min(static_cast<std::size_t>(op->addr_len), op->buffer.size()));
+  }
+
+  op->is_completed = false;
+
+  //! the direction of the operation may be polled for again
+  if (reg.poll_id) { update(fd, reg); }
+
+  submit_if_not_polling_thread();
+
+  return true;
+}
+
+void
+io_uring_poller::cancel_all_operations(void) {
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  for (auto& it : m_fds) {
+    cancel_operation(it.second.rd_operation);
+    cancel_operation(it.second.wr_operation);
+  }
+
+  std::vector<event> events;
+
+  //! the cancellations complete right away, the operations completing in the meantime are simply dropped
+  while (!m_cancelled_operations.empty()) {
+    if (enter(get_nb_unsubmitted_sqes(), 1) < 0 && errno != EINTR) {
+      __TACOPIE_LOG(warn, "io_uring_enter() failure while cancelling operations");
+      break;
+    }
+
+    unsigned int head = *m_cq_head;
+    unsigned int tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head) { process_cqe(m_cqes[head & *m_cq_mask], events); }
+
+    __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+  }
+}
+
+//!
+//! submission queue management
+//!
+
+unsigned int
+io_uring_poller::get_nb_unsubmitted_sqes(void) const {
+  return *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+}
+
+struct io_uring_sqe*
+io_uring_poller::get_sqe(void) {
+  if (get_nb_unsubmitted_sqes() >= m_sq_entries) {
+    enter(get_nb_unsubmitted_sqes(), 0);
+
+    if (get_nb_unsubmitted_sqes() >= m_sq_entries) { __TACOPIE_THROW(error, "io_uring submission queue is full"); }
+  }
+
+  struct io_uring_sqe* sqe = &m_sqes[*m_sq_tail & *m_sq_mask];
+  std::memset(sqe, 0, sizeof(*sqe));
+
+  return sqe;
+}
+
+void
+io_uring_poller::commit_sqe(void) {
+  unsigned int tail             = *m_sq_tail;
+  m_sq_array[tail & *m_sq_mask] = tail & *m_sq_mask;
+
+  __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void
+io_uring_poller::submit_if_not_polling_thread(void) {
+  if (std::this_thread::get_id() == m_polling_thread_id) { return; }
+
+  enter(get_nb_unsubmitted_sqes(), 0);
+}
+
+int
+io_uring_poller::enter(unsigned int to_submit, unsigned int min_complete) {
+  if (!to_submit && !min_complete) { return 0; }
+
+  unsigned int flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+
+  return static_cast<int>(syscall(__NR_io_uring_enter, m_ring_fd, to_submit, min_complete, flags, NULL, 0));
+}
+
+//!
+//! wait for events
+//!
+
+void
+io_uring_poller::wait(std::vector<event>& events, int timeout_msecs) {
+  events.clear();
+
+  unsigned int to_submit;
+  bool has_completions_to_report;
+
+  {
+    std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+    m_polling_thread_id = std::this_thread::get_id();
+
+    for (const auto& fd : m_persistent_fds_to_rearm) {
+      auto it = m_fds.find(fd);
+      if (it != m_fds.end() && !it->second.poll_id) { arm(fd, it->second); }
+    }
+    m_persistent_fds_to_rearm.clear();
+
+    //! completions queued for report are already available: do not wait
+    has_completions_to_report = !m_completions_to_report.empty();
+
+    //! the timeout request completes either when it expires or as soon as another request completes
+    if (timeout_msecs > 0 && !has_completions_to_report) {
+      m_timeout.tv_sec  = timeout_msecs / 1000;
+      m_timeout.tv_nsec = (timeout_msecs % 1000) * 1000000;
+
+      struct io_uring_sqe* sqe = get_sqe();
+      sqe->opcode              = IORING_OP_TIMEOUT;
+      sqe->fd                  = -1;
+      sqe->addr                = reinterpret_cast<std::uint64_t>(&m_timeout);
+      sqe->len                 = 1;
+      sqe->off                 = 1;
+      sqe->user_data           = ignored_user_data;
+      commit_sqe();
+    }
+
+    to_submit = get_nb_unsubmitted_sqes();
+  }
+
+  //! submit the pending requests and wait for completions in a single syscall
+  enter(to_submit, timeout_msecs == 0 || has_completions_to_report ? 0 : 1);
+
+  std::lock_guard<std::mutex> lock(m_ring_mtx);
+
+  //! completions queued by update, unless taken in the meantime
+  for (const auto& completed : m_completions_to_report) {
+    auto it = m_fds.find(completed.fd);
+    if (it == m_fds.end()) { continue; }
+
+    const auto& op = completed.events == rd_event ? it->second.rd_operation : it->second.wr_operation;
+    if (op && op->is_completed) { events.push_back(completed); }
+  }
+  m_completions_to_report.clear();
+
+  unsigned int head = *m_cq_head;
+  unsigned int tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+
+  for (; head != tail; ++head) { process_cqe(m_cqes[head & *m_cq_mask], events); }
+
+  __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+}
+
+void
+io_uring_poller::process_cqe(const struct io_uring_cqe& cqe, std::vector<event>& events) {
+  if (cqe.user_data == ignored_user_data) { return; }
+
+  //! operation cancelled on removal: its buffer can now be released
+  if (!m_cancelled_operations.empty() && m_cancelled_operations.erase(cqe.user_data)) { return; }
+
+  //! ignore completions of requests that have been cancelled or replaced in the meantime
+  auto it = m_fds.find(static_cast<fd_t>(cqe.user_data & 0xffffffff));
+  if (it == m_fds.end()) { return; }
+
+  auto& reg = it->second;
+
+  //! completion of a recv, accept or send
+  for (int direction : {rd_event, wr_event}) {
+    auto& op = direction == rd_event ? reg.rd_operation : reg.wr_operation;
+    if (!op || op->id != cqe.user_data) { continue; }
+
+    op->id           = 0;
+    op->is_completed = true;
+    op->result       = cqe.res;
+
+    if (reg.armed_completions & direction) {
+      reg.armed_completions &= ~direction;
+      events.push_back({it->first, direction});
+    }
+
+    return;
+  }
+
+  if (reg.poll_id != cqe.user_data) { return; }
+
+  reg.poll_id = 0;
+
+  if (cqe.res < 0) { return; }
+
+  int reported = no_event;
+  if (cqe.res & POLLIN) { reported |= rd_event; }
+  if (cqe.res & POLLOUT) { reported |= wr_event; }
+
+  //! errors and hangups are reported as read & write availability too (for the directions that are polled for): the subsequent recv/send reports the failure
+  if (cqe.res & (POLLERR | POLLHUP)) { reported |= (reg.poll_events & (rd_event | wr_event)) | err_event; }
+  if (cqe.res & POLLRDHUP) { reported |= hup_event; }
+
+  events.push_back({it->first, reported});
+
+  //! poll requests are one-shot: persistent fds are re-armed on next wait, once the event has been processed
+  //! re-arming right away could report a stale event if the request was submitted by another thread in the meantime
+  if (reg.persistent) { m_persistent_fds_to_rearm.push_back(it->first); }
+}
+
+poller_type
+io_uring_poller::get_type(void) const {
+  return poller_type::io_uring;
+}
+
+} // namespace tacopie
+
+#endif /* __TACOPIE_HAS_IO_URING */
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef _WIN32
+
+#include <tacopie/network/poll_poller.hpp>
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+
+namespace tacopie {
+
+//!
+//! ctor
+//!
+
+poll_poller::poll_poller(void) {
+  __TACOPIE_LOG(debug, "create poll_poller");
+}
+
+//!
+//! register, update & unregister fds
+//!
+
+void
+poll_poller::add(fd_t fd, int events, bool persistent) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  auto it = m_indexes.find(fd);
+  if (it != m_indexes.end()) {
+    m_persistent[it->second] = persistent;
+    set_fd_events(it->second, events);
+    return;
+  }
+
+  m_indexes[fd] = m_pollfds.size();
+  m_pollfds.push_back({fd, 0, 0});
+  m_fds.push_back(fd);
+  m_persistent.push_back(persistent);
+  set_fd_events(m_pollfds.size() - 1, events);
+}
+
+void
+poll_poller::modify(fd_t fd, int events) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  auto it = m_indexes.find(fd);
+  if (it == m_indexes.end()) { return; }
+
+  set_fd_events(it->second, events);
+}
+
+void
+poll_poller::remove(fd_t fd) {
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  auto it = m_indexes.find(fd);
+  if (it == m_indexes.end()) { return; }
+
+  //! swap with the last entry to keep the arrays contiguous
+  std::size_t index = it->second;
+  std::size_t last  = m_pollfds.size() - 1;
+  if (index != last) {
+    m_pollfds[index]        = m_pollfds[last];
+    m_fds[index]            = m_fds[last];
+    m_persistent[index]     = m_persistent[last];
+    m_indexes[m_fds[index]] = index;
+  }
+
+  m_pollfds.pop_back();
+  m_fds.pop_back();
+  m_persistent.pop_back();
+  m_indexes.erase(it);
+}
+
+void
+poll_poller::set_fd_events(std::size_t index, int events) {
+  struct pollfd& pfd = m_pollfds[index];
+
+  pfd.events = 0;
+  if (events & rd_event) { pfd.events |= POLLIN; }
+  if (events & wr_event) { pfd.events |= POLLOUT; }
+
+  //! POLLERR and POLLHUP are always reported (as long as the fd is armed), POLLRDHUP (linux only) notices the peer closing an idle connection
+#ifdef POLLRDHUP
+  if (events & err_event) { pfd.events |= POLLRDHUP; }
+#endif /* POLLRDHUP */
+
+  pfd.fd = events ? m_fds[index] : -1;
+}
+
+//!
+//! wait for events
+//!
+
+void
+poll_poller::wait(std::vector<event>& events, int timeout_msecs) {
+  events.clear();
+
+  //! the master array can be updated while poll is running, so work on a copy
+  std::vector<struct pollfd> pollfds;
+  std::vector<fd_t> fds;
+
+  {
+    std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+    pollfds = m_pollfds;
+    fds     = m_fds;
+  }
+
+  if (poll(pollfds.data(), pollfds.size(), timeout_msecs) <= 0) { return; }
+
+  std::lock_guard<std::mutex> lock(m_fds_mtx);
+
+  for (std::size_t i = 0; i < pollfds.size(); ++i) {
+    if (!pollfds[i].revents || pollfds[i].fd < 0) { continue; }
+
+    //! the fd may have been removed (or moved) while poll was running
+    auto it = m_indexes.find(fds[i]);
+    if (it == m_indexes.end()) { continue; }
+
+    int reported = no_event;
+
+    if (pollfds[i].revents & POLLIN) { reported |= rd_event; }
+    if (pollfds[i].revents & POLLOUT) { reported |= wr_event; }
+    if (pollfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) { reported |= rd_event | wr_event | err_event; }
+#ifdef POLLRDHUP
+    if (pollfds[i].revents & POLLRDHUP) { reported |= hup_event; }
+#endif /* POLLRDHUP */
+
+    events.push_back({fds[i], reported});
+
+    //! one-shot: disarm until modify() is called
+    if (!m_persistent[it->second]) { set_fd_events(it->second, no_event); }
+  }
+}
+
+poller_type
+poll_poller::get_type(void) const {
+  return poller_type::poll;
+}
+
+} // namespace tacopie
+
+#endif /* _WIN32 */
@@ -26,17 +26,41 @@
 #include <tacopie/network/self_pipe.hpp>
 #include <tacopie/utils/error.hpp>
 
+#include <cstdint>
+
 #include <fcntl.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif /* __linux__ */
+
 namespace tacopie {
 
 //!
 //! ctor & dtor
 //!
 self_pipe::self_pipe(void)
-: m_fds{__TACOPIE_INVALID_FD, __TACOPIE_INVALID_FD} {
+: m_fds{__TACOPIE_INVALID_FD, __TACOPIE_INVALID_FD}
+, m_is_eventfd(false) {
+#ifdef __linux__
+  //! eventfd: a single fd holding a counter, drained by a single read
+  fd_t efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (efd != __TACOPIE_INVALID_FD) {
+    m_fds[0]     = efd;
+    m_fds[1]     = efd;
+    m_is_eventfd = true;
+    return;
+  }
+#endif /* __linux__ */
+
   if (pipe(m_fds) == -1) { __TACOPIE_THROW(error, "pipe() failure"); }
+
+  //! non blocking: notify must never block when the pipe is full, and clr_buffer reads until the pipe is empty
+  for (auto fd : m_fds) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
 }
 
 self_pipe::~self_pipe(void) {
@@ -44,7 +68,7 @@ self_pipe::~self_pipe(void) {
     close(m_fds[0]);
   }
 
-  if (m_fds[1] != __TACOPIE_INVALID_FD) {
+  if (m_fds[1] != __TACOPIE_INVALID_FD && !m_is_eventfd) {
     close(m_fds[1]);
   }
 }
@@ -71,7 +95,13 @@ ___ignore_unused(T1 const&) {}
 //!
 void
 self_pipe::notify(void) {
-  ___ignore_unused(write(m_fds[1], "a", 1));
+  if (m_is_eventfd) {
+    std::uint64_t value = 1;
+    ___ignore_unused(write(m_fds[1], &value, sizeof(value)));
+  }
+  else {
+    ___ignore_unused(write(m_fds[1], "a", 1));
+  }
 }
 
 //!
@@ -79,8 +109,16 @@ self_pipe::notify(void) {
 //!
 void
 self_pipe::clr_buffer(void) {
+  if (m_is_eventfd) {
+    //! reading the counter resets it, whatever the number of pending notifications
+    std::uint64_t value;
+    ___ignore_unused(read(m_fds[0], &value, sizeof(value)));
+    return;
+  }
+
+  //! read until the pipe is empty so that no notification is left pending
   char buf[1024];
-  ___ignore_unused(read(m_fds[0], buf, 1024));
+  while (read(m_fds[0], buf, sizeof(buf)) == sizeof(buf)) {}
 }
 
 } // namespace tacopie
@@ -0,0 +1,343 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/flight_recorder.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif /* __linux__ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace tacopie {
+
+namespace utils {
+
+namespace flight_recorder {
+
+static_assert((__TACOPIE_FLIGHT_RECORDER_SIZE & (__TACOPIE_FLIGHT_RECORDER_SIZE - 1)) == 0, "__TACOPIE_FLIGHT_RECORDER_SIZE must be a power of 2");
+
+//!
+//! timestamps
+//!
+
+static std::uint64_t
+get_timestamp(void) {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t ticks;
+  __asm__ __volatile__("mrs %0, cntvct_el0"
+                       : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+static std::uint64_t
+get_steady_nsecs(void) {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//!
+//! reference points used to compute the timestamp frequency when dumping
+//!
+static const std::uint64_t reference_timestamp  = get_timestamp();
+static const std::uint64_t reference_steady_nsecs = get_steady_nsecs();
+
+static std::uint64_t
+get_ticks_per_second(void) {
+  std::uint64_t elapsed_nsecs = get_steady_nsecs() - reference_steady_nsecs;
+
+  if (!elapsed_nsecs) { return 0; }
+
+  return static_cast<std::uint64_t>(static_cast<double>(get_timestamp() - reference_timestamp) * 1e9 / static_cast<double>(elapsed_nsecs));
+}
+
+//!
+//! per thread buffers
+//!
+
+struct thread_buffer {
+  //! number of entries recorded since the buffer has been claimed
+  std::atomic<std::uint64_t> head;
+  //! whether a thread owns the buffer
+  std::atomic<bool> in_use;
+  //! id of the owning thread
+  std::uint64_t thread_id;
+  //! ring buffer
+  entry entries[__TACOPIE_FLIGHT_RECORDER_SIZE];
+};
+
+//!
+//! buffers are never freed: they can be dumped from a signal handler at any time, and are reused once their thread exits
+//!
+static std::atomic<thread_buffer*> buffers[__TACOPIE_FLIGHT_RECORDER_MAX_THREADS];
+
+static std::atomic<bool> recording_enabled(true);
+
+static std::uint64_t
+get_current_thread_id(void) {
+#if defined(__linux__)
+  return static_cast<std::uint64_t>(syscall(SYS_gettid));
+#else
+  return static_cast<std::uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif /* __linux__ */
+}
+
+static thread_buffer*
+claim_buffer(void) {
+  for (auto& slot : buffers) {
+    thread_buffer* buffer = slot.load(std::memory_order_acquire);
+
+    if (buffer) {
+      bool expected = false;
+      if (!buffer->in_use.compare_exchange_strong(expected, true)) { continue; }
+    }
+    else {
+      thread_buffer* created = new thread_buffer;
+      created->in_use.store(true);
+
+      if (!slot.compare_exchange_strong(buffer, created)) {
+        //! another thread installed a buffer in this slot in the meantime
+        delete created;
+        continue;
+      }
+
+      buffer = created;
+    }
+
+    buffer->thread_id = get_current_thread_id();
+    buffer->head.store(0, std::memory_order_release);
+
+    return buffer;
+  }
+
+  return nullptr;
+}
+
+//!
+//! release the buffer of the thread on exit
+//!
+struct thread_buffer_owner {
+  thread_buffer* buffer = nullptr;
+  bool claimed          = false;
+
+  ~thread_buffer_owner(void) {
+    if (buffer) { buffer->in_use.store(false, std::memory_order_release); }
+  }
+};
+
+static thread_local thread_buffer_owner current_thread_buffer;
+
+//!
+//! recording
+//!
+
+void
+record(event_type type, fd_t fd, std::uint16_t arg) {
+  if (!recording_enabled.load(std::memory_order_relaxed)) { return; }
+
+  auto& owner = current_thread_buffer;
+
+  //! claimed only once: threads that did not get a buffer do not record
+  if (!owner.claimed) {
+    owner.claimed = true;
+    owner.buffer  = claim_buffer();
+  }
+
+  if (!owner.buffer) { return; }
+
+  thread_buffer& buffer = *owner.buffer;
+  std::uint64_t head    = buffer.head.load(std::memory_order_relaxed);
+
+  entry& e    = buffer.entries[head & (__TACOPIE_FLIGHT_RECORDER_SIZE - 1)];
+  e.timestamp = get_timestamp();
+  e.fd        = static_cast<std::int32_t>(fd);
+  e.type      = static_cast<std::uint16_t>(type);
+  e.arg       = arg;
+
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void
+set_enabled(bool enabled) {
+  recording_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool
+is_enabled(void) {
+  return recording_enabled.load(std::memory_order_relaxed);
+}
+
+//!
+//! dump
+//! only async-signal-safe calls from here: no allocation, no lock
+//!
+
+static bool
+write_all(int file, const void* data, std::size_t size) {
+  const char* ptr = static_cast<const char*>(data);
+
+  while (size) {
+#ifdef _WIN32
+    int written = _write(file, ptr, static_cast<unsigned int>(size));
+#else
+    ssize_t written = ::write(file, ptr, size);
+#endif /* _WIN32 */
+
+    if (written <= 0) { return false; }
+
+    ptr += written;
+    size -= static_cast<std::size_t>(written);
+  }
+
+  return true;
+}
+
+static bool
+write_buffer(int file, const thread_buffer& buffer) {
+  std::uint64_t head       = buffer.head.load(std::memory_order_acquire);
+  std::uint64_t nb_entries = head < __TACOPIE_FLIGHT_RECORDER_SIZE ? head : __TACOPIE_FLIGHT_RECORDER_SIZE;
+
+  thread_header header;
+  header.thread_id  = buffer.thread_id;
+  header.nb_entries = static_cast<std::uint32_t>(nb_entries);
+  header.reserved   = 0;
+
+  if (!write_all(file, &header, sizeof(header))) { return false; }
+
+  //! oldest entries first: from the tail to the end of the ring, then from its beginning
+  std::size_t tail  = static_cast<std::size_t>((head - nb_entries) & (__TACOPIE_FLIGHT_RECORDER_SIZE - 1));
+  std::size_t first = static_cast<std::size_t>(nb_entries) < __TACOPIE_FLIGHT_RECORDER_SIZE - tail ? static_cast<std::size_t>(nb_entries) : __TACOPIE_FLIGHT_RECORDER_SIZE - tail;
+
+  if (!write_all(file, &buffer.entries[tail], first * sizeof(entry))) { return false; }
+
+  return write_all(file, &buffer.entries[0], (static_cast<std::size_t>(nb_entries) - first) * sizeof(entry));
+}
+
+static bool
+write_dump(const char* path) {
+#ifdef _WIN32
+  int file = _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  int file = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif /* _WIN32 */
+
+  if (file < 0) { return false; }
+
+  //! the number of buffers may grow while dumping: only the ones counted in the header are written
+  file_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "TACOFR1", 8);
+  header.version          = format_version;
+  header.ticks_per_second = get_ticks_per_second();
+  header.dumped_at        = get_timestamp();
+
+  thread_buffer* dumped[__TACOPIE_FLIGHT_RECORDER_MAX_THREADS];
+  for (auto& slot : buffers) {
+    thread_buffer* buffer = slot.load(std::memory_order_acquire);
+    if (buffer) { dumped[header.nb_threads++] = buffer; }
+  }
+
+  bool success = write_all(file, &header, sizeof(header));
+  for (std::uint32_t i = 0; success && i < header.nb_threads; ++i) { success = write_buffer(file, *dumped[i]); }
+
+#ifdef _WIN32
+  _close(file);
+#else
+  ::close(file);
+#endif /* _WIN32 */
+
+  return success;
+}
+
+void
+dump(const std::string& path) {
+  if (!write_dump(path.c_str())) { __TACOPIE_THROW(error, "flight_recorder: could not write " + path); }
+}
+
+//!
+//! path of the dump written on signal (copied, as the handler cannot allocate)
+//!
+static char signal_dump_path[4096];
+
+static void
+on_dump_signal(int) {
+  write_dump(signal_dump_path);
+}
+
+void
+dump_on_signal(int signal_number, const std::string& path) {
+  if (path.size() >= sizeof(signal_dump_path)) { __TACOPIE_THROW(error, "flight_recorder: dump path is too long"); }
+
+  std::memcpy(signal_dump_path, path.c_str(), path.size() + 1);
+
+  if (std::signal(signal_number, &on_dump_signal) == SIG_ERR) { __TACOPIE_THROW(error, "flight_recorder: signal() failure"); }
+}
+
+//!
+//! event names
+//!
+
+const char*
+get_event_name(std::uint16_t type) {
+  switch (static_cast<event_type>(type)) {
+  case event_type::track: return "track";
+  case event_type::untrack: return "untrack";
+  case event_type::ready: return "ready";
+  case event_type::dispatch: return "dispatch";
+  case event_type::callback_start: return "callback_start";
+  case event_type::callback_end: return "callback_end";
+  case event_type::wake_up: return "wake_up";
+  case event_type::notifier_wake: return "notifier_wake";
+  default: return "unknown";
+  }
+}
+
+} // namespace flight_recorder
+
+} // namespace utils
+
+} // namespace tacopie
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/utils/histogram.hpp>
+
+#include <cmath>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! index of the highest bit set (value must not be 0)
+//!
+
+static unsigned int
+get_highest_bit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+#else
+  unsigned int bit = 0;
+  while (value >>= 1) { ++bit; }
+  return bit;
+#endif /* __GNUC__ || __clang__ */
+}
+
+//!
+//! ctor
+//!
+
+histogram::histogram(void) {
+  reset();
+}
+
+//!
+//! record & reset
+//!
+
+void
+histogram::record(std::uint64_t value) {
+  m_buckets[get_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+
+  std::uint64_t max = m_max.load(std::memory_order_relaxed);
+  while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+void
+histogram::reset(void) {
+  for (auto& bucket : m_buckets) { bucket.store(0, std::memory_order_relaxed); }
+
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+//!
+//! readers
+//!
+
+std::uint64_t
+histogram::get_count(void) const {
+  return m_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+histogram::get_max(void) const {
+  return m_max.load(std::memory_order_relaxed);
+}
+
+double
+histogram::get_mean(void) const {
+  std::uint64_t count = get_count();
+
+  return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0;
+}
+
+std::uint64_t
+histogram::get_value_at_percentile(double percentile) const {
+  std::uint64_t count = get_count();
+
+  if (!count) { return 0; }
+
+  //! rank of the value matching the percentile (at least the first value)
+  auto rank = static_cast<std::uint64_t>(std::ceil(static_cast<double>(count) * percentile / 100));
+  if (rank == 0) { rank = 1; }
+
+  std::uint64_t cumulated = 0;
+
+  for (std::size_t i = 0; i < nb_buckets; ++i) {
+    cumulated += m_buckets[i].load(std::memory_order_relaxed);
+
+    if (cumulated >= rank) {
+      //! the bucket may extend beyond the highest recorded value
+      std::uint64_t upper_bound = get_bucket_upper_bound(i);
+      std::uint64_t max         = get_max();
+
+      return upper_bound < max ? upper_bound : max;
+    }
+  }
+
+  //! values recorded while iterating
+  return get_max();
+}
+
+std::vector<std::pair<std::uint64_t, std::uint64_t>>
+histogram::get_buckets(void) const {
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> buckets;
+
+  for (std::size_t i = 0; i < nb_buckets; ++i) {
+    std::uint64_t count = m_buckets[i].load(std::memory_order_relaxed);
+
+    if (count) { buckets.push_back({get_bucket_upper_bound(i), count}); }
+  }
+
+  return buckets;
+}
+
+//!
+//! buckets layout
+//!
+
+std::size_t
+histogram::get_bucket_index(std::uint64_t value) {
+  if (value < nb_sub_buckets) { return static_cast<std::size_t>(value); }
+
+  //! range [2^bit, 2^(bit+1)) is split into nb_sub_buckets sub-buckets of 2^(bit - precision bits) values
+  unsigned int bit   = get_highest_bit(value);
+  unsigned int shift = bit - __TACOPIE_HISTOGRAM_PRECISION_BITS;
+
+  return ((shift + 1) * nb_sub_buckets) + static_cast<std::size_t>((value >> shift) & (nb_sub_buckets - 1));
+}
+
+std::uint64_t
+histogram::get_bucket_upper_bound(std::size_t index) {
+  if (index < nb_sub_buckets) { return index; }
+
+  std::size_t shift = index / nb_sub_buckets - 1;
+  std::uint64_t sub = index % nb_sub_buckets;
+
+  std::uint64_t lower_bound = (nb_sub_buckets + sub) << shift;
+
+  return lower_bound + ((static_cast<std::uint64_t>(1) << shift) - 1);
+}
+
+} // namespace utils
+
+} // namespace tacopie
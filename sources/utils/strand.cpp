@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/utils/logger.hpp>
+#include <tacopie/utils/strand.hpp>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! ctors
+//!
+
+strand::strand(thread_pool& executor)
+: strand([&executor](task_t&& task) { executor << std::move(task); }) {}
+
+strand::strand(const executor_t& executor)
+: m_executor(executor)
+, m_is_scheduled(false) {}
+
+//!
+//! add tasks to strand
+//!
+
+void
+strand::post(task_t task) {
+  {
+    std::lock_guard<std::mutex> lock(m_tasks_mtx);
+
+    m_tasks.push(std::move(task));
+
+    //! the tasks are already being processed
+    if (m_is_scheduled) { return; }
+
+    m_is_scheduled = true;
+  }
+
+  schedule();
+}
+
+strand&
+strand::operator<<(task_t task) {
+  post(std::move(task));
+
+  return *this;
+}
+
+//!
+//! execute pending tasks
+//!
+
+void
+strand::run(void) {
+  for (std::size_t i = 0; i < __TACOPIE_STRAND_MAX_BATCH; ++i) {
+    task_t task;
+
+    {
+      std::lock_guard<std::mutex> lock(m_tasks_mtx);
+
+      if (m_tasks.empty()) {
+        m_is_scheduled = false;
+        return;
+      }
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop();
+    }
+
+    try {
+      task();
+    }
+    catch (const std::exception&) {
+      __TACOPIE_LOG(warn, "uncatched exception propagated up to the strand.")
+    }
+  }
+
+  //! give the worker back to the other tasks of the executor, the remaining ones are executed later on
+  schedule();
+}
+
+void
+strand::schedule(void) {
+  auto self = shared_from_this();
+
+  m_executor([self] { self->run(); });
+}
+
+} // namespace utils
+
+} // namespace tacopie
@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/utils/error.hpp>
+#include <tacopie/utils/logger.hpp>
+#include <tacopie/utils/thread_config.hpp>
+
+#include <cstdlib>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif /* _WIN32 */
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! thread affinity
+//!
+
+static void
+set_native_thread_affinity(std::thread::native_handle_type thread, const std::vector<std::size_t>& cpus) {
+  if (cpus.empty()) { return; }
+
+#ifdef _WIN32
+  DWORD_PTR mask = 0;
+  for (auto cpu : cpus) {
+    if (cpu < sizeof(DWORD_PTR) * 8) { mask |= static_cast<DWORD_PTR>(1) << cpu; }
+  }
+
+  if (!mask || !SetThreadAffinityMask(thread, mask)) { __TACOPIE_THROW(error, "SetThreadAffinityMask() failure"); }
+#elif defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu < CPU_SETSIZE) { CPU_SET(cpu, &cpu_set); }
+  }
+
+  if (pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set)) { __TACOPIE_THROW(error, "pthread_setaffinity_np() failure"); }
+#else
+  (void) thread;
+  __TACOPIE_LOG(warn, "thread affinity is not supported on this platform");
+#endif /* _WIN32 */
+}
+
+void
+set_thread_affinity(std::thread& thread, const std::vector<std::size_t>& cpus) {
+  set_native_thread_affinity(thread.native_handle(), cpus);
+}
+
+void
+set_current_thread_affinity(const std::vector<std::size_t>& cpus) {
+#ifdef _WIN32
+  set_native_thread_affinity(GetCurrentThread(), cpus);
+#else
+  set_native_thread_affinity(pthread_self(), cpus);
+#endif /* _WIN32 */
+}
+
+std::vector<std::size_t>
+get_allowed_cpus(void) {
+  std::vector<std::size_t> cpus;
+
+#ifdef _WIN32
+  DWORD_PTR process_mask;
+  DWORD_PTR system_mask;
+  if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+    for (std::size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+      if (process_mask & (static_cast<DWORD_PTR>(1) << cpu)) { cpus.push_back(cpu); }
+    }
+  }
+#elif defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (!sched_getaffinity(0, sizeof(cpu_set), &cpu_set)) {
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpu_set)) { cpus.push_back(cpu); }
+    }
+  }
+#endif /* _WIN32 */
+
+  //! unknown: assume every cpu is allowed
+  if (cpus.empty()) {
+    std::size_t nb_cpus = std::thread::hardware_concurrency();
+    for (std::size_t cpu = 0; cpu < (nb_cpus ? nb_cpus : 1); ++cpu) { cpus.push_back(cpu); }
+  }
+
+  return cpus;
+}
+
+//!
+//! thread name
+//!
+
+#ifdef _WIN32
+//! SetThreadDescription is only available from windows 10: resolved at runtime
+typedef HRESULT(WINAPI* set_thread_description_t)(HANDLE, PCWSTR);
+
+static void
+set_native_thread_name(HANDLE thread, const std::string& name) {
+  auto set_thread_description = reinterpret_cast<set_thread_description_t>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+
+  if (!set_thread_description) {
+    __TACOPIE_LOG(debug, "thread naming is not supported on this platform");
+    return;
+  }
+
+  set_thread_description(thread, std::wstring(name.begin(), name.end()).c_str());
+}
+#endif /* _WIN32 */
+
+void
+set_thread_name(std::thread& thread, const std::string& name) {
+#ifdef _WIN32
+  set_native_thread_name(thread.native_handle(), name);
+#elif defined(__linux__)
+  //! names are limited to 16 bytes, including the terminating null byte
+  pthread_setname_np(thread.native_handle(), name.substr(0, 15).c_str());
+#else
+  (void) thread;
+  (void) name;
+  __TACOPIE_LOG(debug, "thread naming is not supported on this platform");
+#endif /* _WIN32 */
+}
+
+void
+set_current_thread_name(const std::string& name) {
+#ifdef _WIN32
+  set_native_thread_name(GetCurrentThread(), name);
+#elif defined(__linux__)
+  pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+  pthread_setname_np(name.c_str());
+#else
+  (void) name;
+  __TACOPIE_LOG(debug, "thread naming is not supported on this platform");
+#endif /* _WIN32 */
+}
+
+//!
+//! NUMA topology
+//!
+
+int
+get_numa_node(std::size_t cpu) {
+#ifdef __linux__
+  //! the sysfs directory of a cpu contains a nodeN link to the node it belongs to
+  DIR* dir = opendir(("/sys/devices/system/cpu/cpu" + std::to_string(cpu)).c_str());
+
+  if (!dir) { return -1; }
+
+  int node = -1;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string entry_name = entry->d_name;
+
+    if (entry_name.size() > 4 && entry_name.compare(0, 4, "node") == 0 && entry_name[4] >= '0' && entry_name[4] <= '9') {
+      node = std::atoi(entry_name.c_str() + 4);
+      break;
+    }
+  }
+
+  closedir(dir);
+
+  return node;
+#else
+  (void) cpu;
+  return -1;
+#endif /* __linux__ */
+}
+
+std::vector<std::size_t>
+get_numa_node_cpus(int node) {
+  std::vector<std::size_t> cpus;
+
+#ifdef __linux__
+  if (node < 0) { return cpus; }
+
+  //! cpulist is formatted as a list of ranges, such as 0-3,8-11
+  std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string range;
+
+  while (std::getline(cpulist, range, ',')) {
+    auto separator = range.find('-');
+    auto first     = std::strtoul(range.c_str(), nullptr, 10);
+    auto last      = separator == std::string::npos ? first : std::strtoul(range.c_str() + separator + 1, nullptr, 10);
+
+    for (auto cpu = first; cpu <= last; ++cpu) { cpus.push_back(cpu); }
+  }
+#else
+  (void) node;
+#endif /* __linux__ */
+
+  return cpus;
+}
+
+} // namespace utils
+
+} // namespace tacopie
@@ -20,7 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <tacopie/utils/error.hpp>
 #include <tacopie/utils/logger.hpp>
+#include <tacopie/utils/thread_config.hpp>
 #include <tacopie/utils/thread_pool.hpp>
 
 namespace tacopie {
@@ -46,13 +48,15 @@ thread_pool::~thread_pool(void) {
 //!
 
 void
-thread_pool::run(void) {
+thread_pool::run(std::size_t index) {
   __TACOPIE_LOG(debug, "start run() worker");
 
+  std::size_t config_generation = 0;
+
   while (true) {
-    auto res     = fetch_task_or_stop();
+    auto res     = fetch_task_or_stop(index, config_generation);
     bool stopped = res.first;
-    task_t task  = res.second;
+    task_t task  = std::move(res.second);
 
     //! if thread has been requested to stop, stop it here
     if (stopped) {
@@ -103,12 +107,66 @@ thread_pool::is_running(void) const {
   return !m_should_stop;
 }
 
+//!
+//! number of tasks waiting for a worker
+//!
+std::size_t
+thread_pool::get_nb_pending_tasks(void) const {
+  return m_nb_pending_tasks;
+}
+
+std::size_t
+thread_pool::get_nb_threads(void) const {
+  return m_max_nb_threads;
+}
+
+//!
+//! share of the workers reserved to high priority tasks
+//!
+void
+thread_pool::set_high_priority_share(std::size_t share) {
+  m_high_priority_share = share;
+}
+
+//!
+//! workers configuration
+//!
+void
+thread_pool::set_workers_affinity(const std::vector<std::vector<std::size_t>>& cpus) {
+  std::lock_guard<std::mutex> lock(m_tasks_mtx);
+
+  m_workers_cpus = cpus;
+  ++m_workers_config_generation;
+  m_tasks_condvar.notify_all();
+}
+
+void
+thread_pool::set_workers_name(const std::string& name) {
+  std::lock_guard<std::mutex> lock(m_tasks_mtx);
+
+  m_workers_name = name;
+  ++m_workers_config_generation;
+  m_tasks_condvar.notify_all();
+}
+
+void
+thread_pool::apply_worker_config(const std::vector<std::size_t>& cpus, const std::string& name) {
+  //! a configuration that can't be applied must not stop the worker
+  try {
+    if (!cpus.empty()) { set_current_thread_affinity(cpus); }
+    if (!name.empty()) { set_current_thread_name(name); }
+  }
+  catch (const tacopie_error&) {
+    __TACOPIE_LOG(warn, "could not apply thread_pool workers configuration");
+  }
+}
+
 //!
 //! whether the current thread should stop or not
 //!
 bool
-thread_pool::should_stop(void) const {
-  return m_should_stop || m_nb_running_threads > m_max_nb_threads;
+thread_pool::should_stop(std::size_t index) const {
+  return m_should_stop || index >= m_max_nb_threads;
 }
 
 //!
@@ -116,21 +174,51 @@ thread_pool::should_stop(void) const {
 //!
 
 std::pair<bool, thread_pool::task_t>
-thread_pool::fetch_task_or_stop(void) {
+thread_pool::fetch_task_or_stop(std::size_t index, std::size_t& config_generation) {
   std::unique_lock<std::mutex> lock(m_tasks_mtx);
 
   __TACOPIE_LOG(debug, "waiting to fetch task");
 
-  m_tasks_condvar.wait(lock, [&] { return should_stop() || !m_tasks.empty(); });
+  m_tasks_condvar.wait(lock, [&] { return should_stop(index) || config_generation != m_workers_config_generation || !m_tasks.empty() || !m_high_priority_tasks.empty(); });
 
-  if (should_stop()) {
+  if (should_stop(index)) {
     --m_nb_running_threads;
+    m_workers_indexes[index] = false;
     return {true, nullptr};
   }
 
-  task_t task = std::move(m_tasks.front());
-  m_tasks.pop();
-  return {false, task};
+  //! configuration changed: the worker applies it before fetching its next task
+  if (config_generation != m_workers_config_generation) {
+    config_generation = m_workers_config_generation;
+
+    std::vector<std::size_t> cpus;
+    if (!m_workers_cpus.empty()) { cpus = m_workers_cpus[index % m_workers_cpus.size()]; }
+
+    std::string name;
+    if (!m_workers_name.empty()) { name = m_workers_name + "-" + std::to_string(index); }
+
+    return {false, std::bind(&thread_pool::apply_worker_config, cpus, name)};
+  }
+
+  std::size_t share = m_high_priority_share;
+  task_t task;
+
+  //! high priority tasks first, unless they already used their share while normal priority tasks are waiting
+  if (!m_high_priority_tasks.empty() && (m_tasks.empty() || !share || m_nb_consecutive_high_priority_tasks < share)) {
+    task = std::move(m_high_priority_tasks.front());
+    m_high_priority_tasks.pop();
+
+    if (!m_tasks.empty()) { ++m_nb_consecutive_high_priority_tasks; }
+  }
+  else {
+    task = std::move(m_tasks.front());
+    m_tasks.pop();
+
+    m_nb_consecutive_high_priority_tasks = 0;
+  }
+
+  --m_nb_pending_tasks;
+  return {false, std::move(task)};
 }
 
 //!
@@ -138,18 +226,25 @@ thread_pool::fetch_task_or_stop(void) {
 //!
 
 void
-thread_pool::add_task(const task_t& task) {
+thread_pool::add_task(task_t task, priority task_priority) {
   std::lock_guard<std::mutex> lock(m_tasks_mtx);
 
   __TACOPIE_LOG(debug, "add task to thread_pool");
 
-  m_tasks.push(task);
+  if (task_priority == priority::high) {
+    m_high_priority_tasks.push(std::move(task));
+  }
+  else {
+    m_tasks.push(std::move(task));
+  }
+
+  ++m_nb_pending_tasks;
   m_tasks_condvar.notify_one();
 }
 
 thread_pool&
-thread_pool::operator<<(const task_t& task) {
-  add_task(task);
+thread_pool::operator<<(task_t task) {
+  add_task(std::move(task));
 
   return *this;
 }
@@ -159,12 +254,20 @@ thread_pool::operator<<(const task_t& task) {
 //!
 void
 thread_pool::set_nb_threads(std::size_t nb_threads) {
+  std::lock_guard<std::mutex> lock(m_tasks_mtx);
+
   m_max_nb_threads = nb_threads;
 
-  //! if we increased the number of threads, spawn them
-  while (m_nb_running_threads < m_max_nb_threads) {
+  //! if we increased the number of threads, spawn them on the indexes left free by the stopped threads
+  //! threads beyond the new number are stopping, and do not count
+  if (m_workers_indexes.size() < nb_threads) { m_workers_indexes.resize(nb_threads, false); }
+
+  for (std::size_t index = 0; index < nb_threads; ++index) {
+    if (m_workers_indexes[index]) { continue; }
+
+    m_workers_indexes[index] = true;
     ++m_nb_running_threads;
-    m_workers.push_back(std::thread(std::bind(&thread_pool::run, this)));
+    m_workers.push_back(std::thread(std::bind(&thread_pool::run, this, index)));
   }
 
   //! otherwise, wake up threads to make them stop if necessary (until we get the right amount of threads)
@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/utils/timer_wheel.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace tacopie {
+
+namespace utils {
+
+//!
+//! wheel geometry: 64 slots per level
+//!
+
+static const std::size_t timer_wheel_slot_bits  = 6;
+static const std::uint64_t timer_wheel_slot_mask = (1ULL << timer_wheel_slot_bits) - 1;
+static const std::uint64_t timer_wheel_range     = 1ULL << (timer_wheel_slot_bits * __TACOPIE_TIMER_WHEEL_NB_LEVELS);
+
+//!
+//! ctor
+//!
+
+timer_wheel::timer_wheel(void)
+: m_level_sizes()
+, m_origin(clock_t::now())
+, m_current_tick(0)
+, m_next_id(1) {}
+
+//!
+//! schedule & cancel timers
+//!
+
+timer_wheel::timer_id_t
+timer_wheel::schedule_after(std::uint32_t delay_msecs, const callback_t& callback, const clock_t::time_point& now) {
+  //! an empty wheel may not have been advanced for a while: catch up with the clock first, so that the timer is placed relative to the current tick
+  if (m_timers.empty()) { m_current_tick = std::max(m_current_tick, get_tick(now)); }
+
+  //! round up so that the timer never expires before the delay elapsed
+  std::uint64_t elapsed_usecs = now > m_origin ? std::chrono::duration_cast<std::chrono::microseconds>(now - m_origin).count() : 0;
+  std::uint64_t expiry        = (elapsed_usecs + static_cast<std::uint64_t>(delay_msecs) * 1000 + 999) / 1000;
+
+  //! the slot of the current tick has already been processed
+  if (expiry <= m_current_tick) { expiry = m_current_tick + 1; }
+
+  std::list<timer> new_timer;
+  new_timer.push_back({m_next_id++, expiry, callback});
+
+  timer_id_t id = new_timer.front().id;
+  insert(new_timer, new_timer.begin());
+
+  return id;
+}
+
+bool
+timer_wheel::cancel(timer_id_t id) {
+  auto it = m_timers.find(id);
+
+  if (it == m_timers.end()) { return false; }
+
+  m_slots[it->second.level][it->second.slot].erase(it->second.it);
+  --m_level_sizes[it->second.level];
+  m_timers.erase(it);
+
+  return true;
+}
+
+void
+timer_wheel::insert(std::list<timer>& from, std::list<timer>::iterator it) {
+  std::uint64_t expiry = std::max(it->expiry, m_current_tick);
+  std::uint64_t delta  = expiry - m_current_tick;
+
+  std::size_t level = 0;
+  while (level < __TACOPIE_TIMER_WHEEL_NB_LEVELS - 1 && delta >= (1ULL << (timer_wheel_slot_bits * (level + 1)))) { ++level; }
+
+  //! beyond the range of the wheel: park the timer in the farthest slot, it is re-inserted when cascaded
+  if (delta >= timer_wheel_range) { expiry = m_current_tick + timer_wheel_range - 1; }
+
+  std::size_t slot = (expiry >> (timer_wheel_slot_bits * level)) & timer_wheel_slot_mask;
+
+  auto& target = m_slots[level][slot];
+  target.splice(target.end(), from, it);
+  ++m_level_sizes[level];
+
+  m_timers[it->id] = {level, slot, it};
+}
+
+std::size_t
+timer_wheel::cascade(std::size_t level) {
+  std::size_t slot = (m_current_tick >> (timer_wheel_slot_bits * level)) & timer_wheel_slot_mask;
+
+  std::list<timer> cascaded;
+  cascaded.splice(cascaded.begin(), m_slots[level][slot]);
+  m_level_sizes[level] -= cascaded.size();
+
+  while (!cascaded.empty()) { insert(cascaded, cascaded.begin()); }
+
+  return slot;
+}
+
+//!
+//! advance the wheel
+//!
+
+void
+timer_wheel::advance(std::vector<callback_t>& expired, const clock_t::time_point& now) {
+  std::uint64_t now_tick = get_tick(now);
+
+  while (m_current_tick < now_tick) {
+    if (m_timers.empty()) {
+      m_current_tick = now_tick;
+      break;
+    }
+
+    //! nothing can expire before the next cascade: skip the ticks in between
+    if (!m_level_sizes[0] && (m_current_tick & timer_wheel_slot_mask) != timer_wheel_slot_mask) {
+      m_current_tick = std::min(m_current_tick | timer_wheel_slot_mask, now_tick);
+      continue;
+    }
+
+    ++m_current_tick;
+
+    //! cascade the higher levels whenever the lower level wraps
+    if (!(m_current_tick & timer_wheel_slot_mask)) {
+      for (std::size_t level = 1; level < __TACOPIE_TIMER_WHEEL_NB_LEVELS && !cascade(level); ++level) {}
+    }
+
+    auto& slot = m_slots[0][m_current_tick & timer_wheel_slot_mask];
+    while (!slot.empty()) {
+      expired.push_back(std::move(slot.front().callback));
+      m_timers.erase(slot.front().id);
+      slot.pop_front();
+      --m_level_sizes[0];
+    }
+  }
+}
+
+//!
+//! next expiry
+//!
+
+int
+timer_wheel::get_next_expiry_msecs(const clock_t::time_point& now) const {
+  if (m_timers.empty()) { return -1; }
+
+  std::uint64_t next_tick = std::numeric_limits<std::uint64_t>::max();
+
+  //! earliest non empty slot of each level: expiry for the first level, cascade for the others
+  for (std::size_t level = 0; level < __TACOPIE_TIMER_WHEEL_NB_LEVELS; ++level) {
+    if (!m_level_sizes[level]) { continue; }
+
+    std::size_t shift = timer_wheel_slot_bits * level;
+    for (std::uint64_t i = 1; i <= timer_wheel_slot_mask + 1; ++i) {
+      std::uint64_t index = (m_current_tick >> shift) + i;
+
+      if (!m_slots[level][index & timer_wheel_slot_mask].empty()) {
+        next_tick = std::min(next_tick, index << shift);
+        break;
+      }
+    }
+  }
+
+  std::uint64_t now_tick = get_tick(now);
+  if (next_tick <= now_tick) { return 0; }
+
+  return static_cast<int>(std::min<std::uint64_t>(next_tick - now_tick, std::numeric_limits<int>::max()));
+}
+
+std::size_t
+timer_wheel::size(void) const {
+  return m_timers.size();
+}
+
+std::uint64_t
+timer_wheel::get_tick(const clock_t::time_point& now) const {
+  if (now <= m_origin) { return 0; }
+
+  return std::chrono::duration_cast<std::chrono::milliseconds>(now - m_origin).count();
+}
+
+} // namespace utils
+
+} // namespace tacopie
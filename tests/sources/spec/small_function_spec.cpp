@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/network/io_service.hpp>
+#include <tacopie/utils/small_function.hpp>
+#include <tacopie/utils/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+//!
+//! global operator new replaced by a counting version
+//! allocations are only counted (from any thread) while counting is enabled
+//!
+
+static std::atomic<bool> counting_allocations(false);
+static std::atomic<std::size_t> nb_allocations(0);
+
+//! kept out of line: once inlined into callers, gcc would report free() as mismatched with their new (-Wmismatched-new-delete)
+#ifdef __GNUC__
+#define __TACOPIE_SPEC_NOINLINE __attribute__((noinline))
+#else
+#define __TACOPIE_SPEC_NOINLINE
+#endif /* __GNUC__ */
+
+static __TACOPIE_SPEC_NOINLINE void*
+counted_allocate(std::size_t size) {
+  if (counting_allocations) { ++nb_allocations; }
+
+  return std::malloc(size ? size : 1);
+}
+
+static __TACOPIE_SPEC_NOINLINE void
+counted_deallocate(void* ptr) {
+  std::free(ptr);
+}
+
+void*
+operator new(std::size_t size) {
+  void* ptr = counted_allocate(size);
+  if (!ptr) { throw std::bad_alloc(); }
+
+  return ptr;
+}
+
+void*
+operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return counted_allocate(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+
+void
+operator delete(void* ptr) noexcept {
+  counted_deallocate(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept {
+  counted_deallocate(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept {
+  counted_deallocate(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept {
+  counted_deallocate(ptr);
+}
+
+static void
+start_counting_allocations(void) {
+  nb_allocations       = 0;
+  counting_allocations = true;
+}
+
+static std::size_t
+stop_counting_allocations(void) {
+  counting_allocations = false;
+  return nb_allocations;
+}
+
+//!
+//! task wrapping a callback, the way the io_service hands callbacks over to its workers
+//!
+
+struct callback_task {
+  tacopie::io_service::event_callback_t callback;
+  tacopie::fd_t fd;
+
+  void
+  operator()(void) {
+    callback(fd);
+  }
+};
+
+//!
+//! moves of callbacks and tasks
+//!
+
+TEST(SmallFunction, MovesDoNotAllocate) {
+  int nb_calls = 0;
+
+  start_counting_allocations();
+
+  tacopie::io_service::event_callback_t callback = [&nb_calls](tacopie::fd_t) { ++nb_calls; };
+  tacopie::io_service::event_callback_t moved_callback;
+  moved_callback = std::move(callback);
+  moved_callback(0);
+
+  tacopie::utils::thread_pool::task_t task = callback_task{std::move(moved_callback), 0};
+  tacopie::utils::thread_pool::task_t moved_task(std::move(task));
+  moved_task();
+
+  std::size_t allocations = stop_counting_allocations();
+
+  EXPECT_EQ(0U, allocations);
+  EXPECT_EQ(2, nb_calls);
+  EXPECT_FALSE(static_cast<bool>(callback));
+  EXPECT_FALSE(static_cast<bool>(task));
+}
+
+#ifndef _WIN32
+
+//!
+//! steady-state dispatch of read and write callbacks
+//! the write callback of the write end of a pipe writes a byte, that the read callback of the read end consumes
+//!
+
+struct pipe_events {
+  pipe_events(void)
+  : nb_reads(0)
+  , nb_writes(0) {
+    if (pipe(fds) == -1) { throw std::runtime_error("pipe() failure"); }
+
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+  }
+
+  ~pipe_events(void) {
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  void
+  track(tacopie::io_service& service) {
+    service.track_fd(fds[0], [this](tacopie::fd_t fd) {
+      char buffer[64];
+      if (read(fd, buffer, sizeof(buffer)) > 0) { ++nb_reads; }
+    });
+
+    service.track_fd(fds[1], nullptr, [this](tacopie::fd_t fd) {
+      char byte = 0;
+      if (write(fd, &byte, 1) == 1) { ++nb_writes; }
+    });
+  }
+
+  void
+  untrack(tacopie::io_service& service) {
+    service.untrack_fd(fds[0]);
+    service.untrack_fd(fds[1]);
+    service.wait_for_fd_removal(fds[0]);
+    service.wait_for_fd_removal(fds[1]);
+  }
+
+  int fds[2];
+  std::atomic<std::size_t> nb_reads;
+  std::atomic<std::size_t> nb_writes;
+};
+
+TEST(SmallFunction, PollThreadDispatchDoesNotAllocate) {
+  tacopie::io_service service(tacopie::poller_type::__TACOPIE_DEFAULT_POLLER, tacopie::io_service::loop_mode::caller_thread);
+  pipe_events events;
+
+  events.track(service);
+
+  //! warm up: containers of the io_service reach their steady-state capacity
+  for (int i = 0; i < 100; ++i) { service.run_once(100); }
+
+  std::size_t nb_reads  = events.nb_reads;
+  std::size_t nb_writes = events.nb_writes;
+
+  start_counting_allocations();
+  for (int i = 0; i < 1000; ++i) { service.run_once(100); }
+  std::size_t allocations = stop_counting_allocations();
+
+  EXPECT_EQ(0U, allocations);
+  EXPECT_LT(nb_reads, events.nb_reads.load());
+  EXPECT_LT(nb_writes, events.nb_writes.load());
+
+  events.untrack(service);
+}
+
+TEST(SmallFunction, WorkersDispatchDoesNotAllocate) {
+  tacopie::io_service service;
+  pipe_events events;
+
+  events.track(service);
+
+  auto wait_for_reads = [&events](std::size_t nb_reads) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (events.nb_reads < nb_reads && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+  };
+
+  //! warm up: containers of the io_service and of the callback workers reach their steady-state capacity
+  wait_for_reads(100);
+
+  std::size_t nb_reads  = events.nb_reads;
+  std::size_t nb_writes = events.nb_writes;
+
+  start_counting_allocations();
+  wait_for_reads(nb_reads + 1000);
+  std::size_t allocations = stop_counting_allocations();
+
+  EXPECT_EQ(0U, allocations);
+  EXPECT_LE(nb_reads + 1000, events.nb_reads.load());
+  EXPECT_LT(nb_writes, events.nb_writes.load());
+
+  events.untrack(service);
+}
+
+#endif /* _WIN32 */
@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <tacopie/utils/timer_wheel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using tacopie::utils::timer_wheel;
+
+//!
+//! advance the wheel to the given time and run the expired callbacks
+//!
+
+static std::size_t
+advance_to(timer_wheel& wheel, const timer_wheel::clock_t::time_point& now) {
+  std::vector<timer_wheel::callback_t> expired;
+  wheel.advance(expired, now);
+
+  for (const auto& callback : expired) { callback(); }
+
+  return expired.size();
+}
+
+static timer_wheel::clock_t::time_point
+after_msecs(const timer_wheel::clock_t::time_point& from, std::uint64_t msecs) {
+  return from + std::chrono::milliseconds(msecs);
+}
+
+//!
+//! the origin of the wheel is set at construction, slightly before t0: a timer of delay d is pending at t0 + d - 1 ms and expired at t0 + d + 1 ms
+//!
+
+TEST(TimerWheel, ExpiresAcrossCascades) {
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  //! level 1 (>= 64 ticks) and level 2 (>= 4096 ticks)
+  std::vector<std::uint32_t> delays = {100, 5000};
+  std::vector<int> fired(delays.size(), 0);
+
+  for (std::size_t i = 0; i < delays.size(); ++i) {
+    wheel.schedule_after(delays[i], [&fired, i] { ++fired[i]; }, t0);
+  }
+
+  for (std::size_t i = 0; i < delays.size(); ++i) {
+    advance_to(wheel, after_msecs(t0, delays[i] - 1));
+    EXPECT_EQ(0, fired[i]);
+
+    advance_to(wheel, after_msecs(t0, delays[i] + 1));
+    EXPECT_EQ(1, fired[i]);
+  }
+
+  EXPECT_EQ(0U, wheel.size());
+  EXPECT_EQ(-1, wheel.get_next_expiry_msecs(after_msecs(t0, delays.back() + 1)));
+}
+
+TEST(TimerWheel, ExpiresInSmallSteps) {
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  int fired = 0;
+  wheel.schedule_after(4200, [&fired] { ++fired; }, t0);
+
+  //! one tick at a time, crossing every level 1 and level 2 cascade on the way
+  for (std::uint64_t msecs = 1; msecs < 4200; ++msecs) { advance_to(wheel, after_msecs(t0, msecs)); }
+  EXPECT_EQ(0, fired);
+
+  advance_to(wheel, after_msecs(t0, 4201));
+  EXPECT_EQ(1, fired);
+}
+
+TEST(TimerWheel, DelayBeyondRange) {
+  const std::uint64_t range = 1ULL << (6 * __TACOPIE_TIMER_WHEEL_NB_LEVELS);
+
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  //! parked in the farthest slot and re-inserted twice before expiring
+  std::uint64_t delay = 2 * range + 100;
+
+  int fired = 0;
+  wheel.schedule_after(static_cast<std::uint32_t>(delay), [&fired] { ++fired; }, t0);
+
+  advance_to(wheel, after_msecs(t0, range));
+  EXPECT_EQ(0, fired);
+  EXPECT_EQ(1U, wheel.size());
+
+  advance_to(wheel, after_msecs(t0, 2 * range));
+  EXPECT_EQ(0, fired);
+  EXPECT_EQ(1U, wheel.size());
+
+  advance_to(wheel, after_msecs(t0, delay - 1));
+  EXPECT_EQ(0, fired);
+
+  advance_to(wheel, after_msecs(t0, delay + 1));
+  EXPECT_EQ(1, fired);
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(TimerWheel, CancelAfterCascade) {
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  int fired = 0;
+  auto cancelled = wheel.schedule_after(5000, [&fired] { ++fired; }, t0);
+  wheel.schedule_after(6000, [] {}, t0);
+
+  //! the level 2 slot holding both timers has been cascaded at tick 4096
+  advance_to(wheel, after_msecs(t0, 4500));
+  EXPECT_EQ(2U, wheel.size());
+
+  EXPECT_TRUE(wheel.cancel(cancelled));
+  EXPECT_FALSE(wheel.cancel(cancelled));
+  EXPECT_EQ(1U, wheel.size());
+
+  EXPECT_EQ(1U, advance_to(wheel, after_msecs(t0, 6001)));
+  EXPECT_EQ(0, fired);
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(TimerWheel, ScheduleAfterIdleGap) {
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  //! the wheel stays empty for 30 days
+  auto idle = after_msecs(t0, 30ULL * 24 * 3600 * 1000);
+  EXPECT_EQ(0U, advance_to(wheel, idle));
+
+  int fired = 0;
+  wheel.schedule_after(10, [&fired] { ++fired; }, idle);
+
+  //! placed relative to the clock, not to the tick the wheel was left at
+  int next_expiry = wheel.get_next_expiry_msecs(idle);
+  EXPECT_GE(next_expiry, 10);
+  EXPECT_LE(next_expiry, 11);
+
+  advance_to(wheel, after_msecs(idle, 9));
+  EXPECT_EQ(0, fired);
+
+  advance_to(wheel, after_msecs(idle, 11));
+  EXPECT_EQ(1, fired);
+}
+
+TEST(TimerWheel, ScheduleAfterIdleGapWithoutAdvance) {
+  timer_wheel wheel;
+  auto t0 = timer_wheel::clock_t::now();
+
+  //! the wheel has never been advanced: scheduling catches up with the clock by itself
+  auto idle = after_msecs(t0, 30ULL * 24 * 3600 * 1000);
+
+  int fired = 0;
+  wheel.schedule_after(10, [&fired] { ++fired; }, idle);
+
+  int next_expiry = wheel.get_next_expiry_msecs(idle);
+  EXPECT_GE(next_expiry, 10);
+  EXPECT_LE(next_expiry, 11);
+
+  advance_to(wheel, after_msecs(idle, 9));
+  EXPECT_EQ(0, fired);
+
+  advance_to(wheel, after_msecs(idle, 11));
+  EXPECT_EQ(1, fired);
+}
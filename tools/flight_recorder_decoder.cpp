@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2016-2017 Simon Ninon <simon.ninon@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <tacopie/network/poller.hpp>
+#include <tacopie/utils/flight_recorder.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using tacopie::poller_iface;
+using namespace tacopie::utils;
+
+//!
+//! decoded entry, along with the thread that recorded it
+//!
+struct decoded_entry {
+  std::uint64_t thread_id;
+  flight_recorder::entry entry;
+};
+
+//!
+//! poller_iface::event_type flags carried by the arg of ready, dispatch and callback events
+//!
+static std::string
+format_events(std::uint16_t events) {
+  std::string formatted;
+
+  if (events & poller_iface::rd_event) { formatted += "rd|"; }
+  if (events & poller_iface::wr_event) { formatted += "wr|"; }
+  if (events & poller_iface::err_event) { formatted += "err|"; }
+
+  if (formatted.empty()) { return "-"; }
+
+  formatted.pop_back();
+  return formatted;
+}
+
+static std::string
+format_arg(const flight_recorder::entry& entry) {
+  switch (static_cast<flight_recorder::event_type>(entry.type)) {
+  case flight_recorder::event_type::ready:
+  case flight_recorder::event_type::dispatch:
+  case flight_recorder::event_type::callback_start:
+  case flight_recorder::event_type::callback_end:
+    return format_events(entry.arg);
+  default:
+    return std::to_string(entry.arg);
+  }
+}
+
+int
+main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <flight recorder dump>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "could not open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  flight_recorder::file_header header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "TACOFR1", 8)) {
+    std::cerr << argv[1] << " is not a flight recorder dump" << std::endl;
+    return 1;
+  }
+
+  if (header.version != flight_recorder::format_version) {
+    std::cerr << "unsupported dump version " << header.version << std::endl;
+    return 1;
+  }
+
+  //! merge the entries of all the threads into a single timeline
+  std::vector<decoded_entry> entries;
+
+  for (std::uint32_t i = 0; i < header.nb_threads; ++i) {
+    flight_recorder::thread_header thread;
+    if (!file.read(reinterpret_cast<char*>(&thread), sizeof(thread))) {
+      std::cerr << "truncated dump" << std::endl;
+      return 1;
+    }
+
+    for (std::uint32_t j = 0; j < thread.nb_entries; ++j) {
+      decoded_entry decoded;
+      decoded.thread_id = thread.thread_id;
+
+      if (!file.read(reinterpret_cast<char*>(&decoded.entry), sizeof(decoded.entry))) {
+        std::cerr << "truncated dump" << std::endl;
+        return 1;
+      }
+
+      entries.push_back(decoded);
+    }
+  }
+
+  std::stable_sort(entries.begin(), entries.end(), [](const decoded_entry& a, const decoded_entry& b) {
+    return a.entry.timestamp < b.entry.timestamp;
+  });
+
+  std::cout << header.nb_threads << " threads, " << entries.size() << " events";
+  if (header.ticks_per_second) {
+    std::cout << ", times in microseconds before the dump" << std::endl;
+  }
+  else {
+    std::cout << ", timestamp frequency unknown: times in ticks before the dump" << std::endl;
+  }
+
+  std::printf("%16s %12s %-16s %8s %s\n", "time", "thread", "event", "fd", "arg");
+
+  for (const auto& decoded : entries) {
+    const auto& entry = decoded.entry;
+
+    //! entries recorded while dumping may be more recent than the dump
+    double ticks_before_dump = static_cast<double>(header.dumped_at) - static_cast<double>(entry.timestamp);
+    double time              = header.ticks_per_second ? ticks_before_dump * 1e6 / static_cast<double>(header.ticks_per_second) : ticks_before_dump;
+
+    std::printf("%16.3f %12llu %-16s %8d %s\n", -time, static_cast<unsigned long long>(decoded.thread_id), flight_recorder::get_event_name(entry.type), entry.fd, format_arg(entry).c_str());
+  }
+
+  return 0;
+}